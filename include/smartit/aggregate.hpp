@@ -0,0 +1,600 @@
+#ifndef SMARTIT_AGGREGATE_HPP
+#define SMARTIT_AGGREGATE_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <numeric>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "algorithm.hpp"
+#include "execution.hpp"
+#include "reduction.hpp"
+#include "value.hpp"
+#include "vector.hpp"
+
+namespace smit {
+
+  namespace core {
+
+    /**
+     * @brief Sum of the values returned by a function on the elements
+     *
+     * Aggregations hold the function called on (constant references to) the
+     * elements, and define the type of their partial state for a type of
+     * value, how to initialize it, to add a value, to merge two states and
+     * to compute the final result.
+     */
+    template <class Function> struct __sum {
+      /// Function returning the value of an element
+      Function function;
+
+      template <class V> using state_type = V;
+
+      template <class V> static state_type<V> init() { return V(0); }
+
+      template <class V> static void add(state_type<V> &state, V value) {
+        state += value;
+      }
+
+      template <class V>
+      static void merge(state_type<V> &state, state_type<V> const &other) {
+        state += other;
+      }
+
+      template <class V> static V result(state_type<V> const &state) {
+        return state;
+      }
+    };
+
+    /// Minimum of the values returned by a function on the elements
+    template <class Function> struct __min {
+      /// Function returning the value of an element
+      Function function;
+
+      template <class V> using state_type = V;
+
+      template <class V> static state_type<V> init() {
+        return _f_highest_value<V>();
+      }
+
+      template <class V> static void add(state_type<V> &state, V value) {
+        state = std::min(state, value);
+      }
+
+      template <class V>
+      static void merge(state_type<V> &state, state_type<V> const &other) {
+        state = std::min(state, other);
+      }
+
+      template <class V> static V result(state_type<V> const &state) {
+        return state;
+      }
+    };
+
+    /// Maximum of the values returned by a function on the elements
+    template <class Function> struct __max {
+      /// Function returning the value of an element
+      Function function;
+
+      template <class V> using state_type = V;
+
+      template <class V> static state_type<V> init() {
+        return _f_lowest_value<V>();
+      }
+
+      template <class V> static void add(state_type<V> &state, V value) {
+        state = std::max(state, value);
+      }
+
+      template <class V>
+      static void merge(state_type<V> &state, state_type<V> const &other) {
+        state = std::max(state, other);
+      }
+
+      template <class V> static V result(state_type<V> const &state) {
+        return state;
+      }
+    };
+
+    /// Mean of the values returned by a function on the elements, computed
+    /// in double precision for integral values
+    template <class Function> struct __mean {
+      /// Function returning the value of an element
+      Function function;
+
+      template <class V>
+      using result_type =
+          std::conditional_t<std::is_floating_point<V>::value, V, double>;
+
+      template <class V>
+      using state_type = std::pair<result_type<V>, std::size_t>;
+
+      template <class V> static state_type<V> init() { return {0, 0}; }
+
+      template <class V> static void add(state_type<V> &state, V value) {
+        state.first += value;
+        ++state.second;
+      }
+
+      template <class V>
+      static void merge(state_type<V> &state, state_type<V> const &other) {
+        state.first += other.first;
+        state.second += other.second;
+      }
+
+      template <class V>
+      static result_type<V> result(state_type<V> const &state) {
+        return state.first / result_type<V>(state.second);
+      }
+    };
+
+    /// Function returning one for any element
+    struct __unit {
+      template <class Element> std::size_t operator()(Element const &) const {
+        return 1;
+      }
+    };
+
+    /// Type of the values of an aggregation for the given element
+    template <class Aggregation, class Element>
+    using aggregated_value_t = std::decay_t<decltype(
+        std::declval<Aggregation const &>().function(
+            std::declval<Element const &>()))>;
+
+    /// Type of the partial state of an aggregation for the given element
+    template <class Aggregation, class Element>
+    using aggregation_state_t = typename Aggregation::template state_type<
+        aggregated_value_t<Aggregation, Element>>;
+
+    /// Type of the result of an aggregation for the given element
+    template <class Aggregation, class Element>
+    using aggregation_result_t =
+        decltype(Aggregation::template result<
+                 aggregated_value_t<Aggregation, Element>>(
+            std::declval<aggregation_state_t<Aggregation, Element> const &>()));
+
+    /**
+     * @brief Partial aggregates of groups of elements
+     *
+     * Stores the keys of the groups, in order of creation, together with
+     * the states of their aggregations. Groups are either appended, when
+     * the keys are known to be new (sorted input), or looked up by key in a
+     * hash table.
+     */
+    template <class Key, class Element, class... Aggregations>
+    class __group_table {
+
+    public:
+      /// Type of the aggregations
+      using aggregations_type = std::tuple<Aggregations...>;
+
+      /// States of the aggregations of a group
+      using states_type =
+          std::tuple<aggregation_state_t<Aggregations, Element>...>;
+
+      /// Build the table from the aggregations
+      explicit __group_table(aggregations_type const &aggregations)
+          : m_aggregations{&aggregations} {}
+
+      /// Number of groups
+      size_t size() const { return m_keys.size(); }
+
+      /// Keys of the groups
+      std::vector<Key> const &keys() const { return m_keys; }
+
+      /// States of the aggregations of the groups
+      std::vector<states_type> const &states() const { return m_states; }
+
+      /// Add a group with the given key at the end, returning its position
+      size_t append(Key const &key) {
+        m_keys.push_back(key);
+        m_states.emplace_back(Aggregations::template init<
+                              aggregated_value_t<Aggregations, Element>>()...);
+        return m_keys.size() - 1;
+      }
+
+      /// Position of the group with the given key, created if needed
+      size_t find(Key const &key) {
+        auto const r = m_positions.try_emplace(key, m_keys.size());
+        if (r.second)
+          this->append(key);
+        return r.first->second;
+      }
+
+      /// Add an element to the group at the given position
+      void add(size_t g, Element const &element) {
+        this->add_impl(m_states[g], element,
+                       std::index_sequence_for<Aggregations...>{});
+      }
+
+      /// Merge the states of the aggregations of another group into those
+      /// of the group at the given position
+      void merge(size_t g, states_type const &other) {
+        this->merge_impl(m_states[g], other,
+                         std::index_sequence_for<Aggregations...>{});
+      }
+
+      /// Result of the I-th aggregation for the group at position g
+      template <size_t I> auto result(size_t g) const {
+        using aggregation = std::tuple_element_t<I, aggregations_type>;
+        return aggregation::template result<
+            aggregated_value_t<aggregation, Element>>(
+            std::get<I>(m_states[g]));
+      }
+
+    private:
+      /// Aggregations
+      aggregations_type const *m_aggregations;
+      /// Keys of the groups
+      std::vector<Key> m_keys;
+      /// States of the aggregations of the groups
+      std::vector<states_type> m_states;
+      /// Position of the group of each key (only for hash-based grouping)
+      std::unordered_map<Key, size_t> m_positions;
+
+      template <size_t... I>
+      void add_impl(states_type &states, Element const &element,
+                    std::index_sequence<I...>) {
+        (std::tuple_element_t<I, aggregations_type>::template add<
+             aggregated_value_t<std::tuple_element_t<I, aggregations_type>,
+                                Element>>(
+             std::get<I>(states),
+             std::get<I>(*m_aggregations).function(element)),
+         ...);
+      }
+
+      template <size_t... I>
+      void merge_impl(states_type &states, states_type const &other,
+                      std::index_sequence<I...>) {
+        (std::tuple_element_t<I, aggregations_type>::template merge<
+             aggregated_value_t<std::tuple_element_t<I, aggregations_type>,
+                                Element>>(std::get<I>(states),
+                                          std::get<I>(other)),
+         ...);
+      }
+    };
+  } // namespace core
+
+  /**
+   * @brief Aggregations computed on the groups of elements with the same
+   * key
+   *
+   * Each of them takes a function returning an arithmetic value for a
+   * (constant reference to an) element.
+   *
+   * @see smit::reduce_by_key
+   */
+  namespace aggregate {
+
+    /// Sum of the values
+    template <class Function> core::__sum<Function> sum(Function f) {
+      return {std::move(f)};
+    }
+
+    /// Minimum of the values
+    template <class Function> core::__min<Function> min(Function f) {
+      return {std::move(f)};
+    }
+
+    /// Maximum of the values
+    template <class Function> core::__max<Function> max(Function f) {
+      return {std::move(f)};
+    }
+
+    /// Mean of the values (in double precision for integral values)
+    template <class Function> core::__mean<Function> mean(Function f) {
+      return {std::move(f)};
+    }
+
+    /// Number of elements
+    inline core::__sum<core::__unit> count() { return {}; }
+  } // namespace aggregate
+
+  /**
+   * @brief Strategies to group the elements by key
+   *
+   * @see smit::reduce_by_key
+   */
+  namespace grouping {
+
+    /// Sort the keys and aggregate consecutive runs of equal keys
+    struct sort_strategy {};
+
+    /// Aggregate in hash tables, one per chunk of elements, merged at the
+    /// end
+    struct hash_strategy {};
+
+    /// Sort-based grouping
+    constexpr sort_strategy sort{};
+    /// Hash-based grouping
+    constexpr hash_strategy hash{};
+
+    /// Check whether a type is a grouping strategy
+    template <class T> struct is_strategy : std::false_type {};
+
+    template <> struct is_strategy<sort_strategy> : std::true_type {};
+
+    template <> struct is_strategy<hash_strategy> : std::true_type {};
+
+    /// Value of smit::grouping::is_strategy
+    template <class T>
+    constexpr bool is_strategy_v = is_strategy<std::decay_t<T>>::value;
+  } // namespace grouping
+
+  /**
+   * @brief Prototype class for the aggregates of a group of elements
+   *
+   * The first field is the key of the group, and the rest are the results
+   * of the aggregations.
+   *
+   * @see smit::reduce_by_key
+   */
+  template <class T> class group_proto : public T {
+
+  public:
+    /// Constructors inherited from the parent class
+    using T::T;
+
+    /// Key of the group
+    auto const &key() const { return get_field_const<0>(*this); }
+    /// Key of the group
+    auto &key() { return get_field<0>(*this); }
+
+    /// Result of the I-th aggregation
+    template <size_t I> auto const &value() const {
+      return get_field_const<I + 1>(*this);
+    }
+    /// Result of the I-th aggregation
+    template <size_t I> auto &value() { return get_field<I + 1>(*this); }
+  };
+
+  /// Aggregates of a group of elements with the given key
+  template <class Key, class... Results>
+  using group = data_object<group_proto, Key, Results...>;
+
+  namespace core {
+
+    /// Type of the key of the elements of a container
+    template <class Container, class Key>
+    using group_key_t = std::decay_t<decltype(std::declval<Key &>()(
+        std::declval<typename Container::const_reference>()))>;
+
+    /// Table of partial aggregates for the elements of a container
+    template <class Container, class Key, class... Aggregations>
+    using group_table_t =
+        __group_table<group_key_t<Container, Key>,
+                      typename Container::const_reference, Aggregations...>;
+
+    /// Container returned by smit::reduce_by_key
+    template <class Container, class Key, class... Aggregations>
+    using reduce_by_key_result_t = smit::vector<
+        group<group_key_t<Container, Key>,
+              aggregation_result_t<Aggregations,
+                                   typename Container::const_reference>...>>;
+
+    /**
+     * @brief Group the elements of a container sorting them by key
+     *
+     * The keys are sorted together with the positions of the elements, and
+     * each chunk of the sorted keys is aggregated in runs of equal keys by a
+     * different thread. The tables of the chunks are then concatenated,
+     * merging the groups split between consecutive chunks, so the groups
+     * are in increasing order of the keys.
+     */
+    template <class Policy, class Container, class Key,
+              class... Aggregations>
+    inline group_table_t<Container, Key, Aggregations...>
+    _f_group_by_sort(Policy const &policy, Container const &container,
+                     Key &key,
+                     std::tuple<Aggregations...> const &aggregations) {
+
+      using table_type = group_table_t<Container, Key, Aggregations...>;
+      using key_type = group_key_t<Container, Key>;
+      using entry_type = std::pair<key_type, size_t>;
+
+      size_t const size = container.size();
+      size_t const chunks = _f_number_of_chunks(policy, size);
+
+      std::vector<entry_type> entries(size);
+
+      _f_parallel_chunks(size, chunks, [&](size_t, size_t b, size_t e) {
+        for (size_t i = b; i < e; ++i)
+          entries[i] = {key(container[i]), i};
+      });
+
+      // stable, so the elements of a group are added in their order
+      _f_sort<true>(policy, entries.begin(), entries.end(),
+                    [](entry_type const &a, entry_type const &b) {
+                      return a.first < b.first;
+                    });
+
+      std::vector<table_type> partial(chunks, table_type{aggregations});
+
+      _f_parallel_chunks(size, chunks, [&](size_t c, size_t b, size_t e) {
+        auto &table = partial[c];
+        size_t g = 0;
+        for (size_t i = b; i < e; ++i) {
+          if (i == b || entries[i].first != entries[i - 1].first)
+            g = table.append(entries[i].first);
+          table.add(g, container[entries[i].second]);
+        }
+      });
+
+      table_type table{aggregations};
+      for (auto const &p : partial)
+        for (size_t g = 0; g < p.size(); ++g) {
+          auto const &k = p.keys()[g];
+          size_t const t = (table.size() != 0 && table.keys().back() == k)
+                               ? table.size() - 1
+                               : table.append(k);
+          table.merge(t, p.states()[g]);
+        }
+
+      return table;
+    }
+
+    /**
+     * @brief Group the elements of a container in hash tables
+     *
+     * The container is split in a contiguous range per thread, and each
+     * range is aggregated in its own table, since any of them can hold all
+     * the groups. The tables are merged in the order of the ranges, so the
+     * result does not depend on the scheduling of the threads. Groups are
+     * in order of first appearance.
+     */
+    template <class Policy, class Container, class Key,
+              class... Aggregations>
+    inline group_table_t<Container, Key, Aggregations...>
+    _f_group_by_hash(Policy const &policy, Container const &container,
+                     Key &key,
+                     std::tuple<Aggregations...> const &aggregations) {
+
+      using table_type = group_table_t<Container, Key, Aggregations...>;
+
+      size_t const size = container.size();
+      size_t const chunks = _f_number_of_partitions(policy, size);
+
+      std::vector<table_type> partial(chunks, table_type{aggregations});
+
+      _f_parallel_chunks(size, chunks, [&](size_t c, size_t b, size_t e) {
+        auto &table = partial[c];
+        for (size_t i = b; i < e; ++i) {
+          auto const &element = container[i];
+          table.add(table.find(key(element)), element);
+        }
+      });
+
+      if (chunks == 1)
+        return std::move(partial.front());
+
+      table_type table{aggregations};
+      for (auto const &p : partial)
+        for (size_t g = 0; g < p.size(); ++g)
+          table.merge(table.find(p.keys()[g]), p.states()[g]);
+
+      return table;
+    }
+
+    /// Build the container with the key and the results of the
+    /// aggregations of the groups at the given positions of a table
+    template <class Output, class Table, size_t... I>
+    inline Output _f_group_results(Table const &table,
+                                   std::vector<size_t> const &order,
+                                   std::index_sequence<I...>) {
+      Output output;
+      output.reserve(order.size());
+      for (size_t g : order)
+        output.emplace_back(table.keys()[g], table.template result<I>(g)...);
+      return output;
+    }
+
+    /// Aggregate the elements of a container by key
+    template <class Policy, class Strategy, class Container, class Key,
+              class... Aggregations>
+    inline reduce_by_key_result_t<Container, Key, Aggregations...>
+    _f_reduce_by_key(Policy const &policy, Strategy, Container const &container,
+                     Key &key,
+                     std::tuple<Aggregations...> const &aggregations) {
+
+      static_assert(std::is_arithmetic<group_key_t<Container, Key>>::value,
+                    "The key must be an arithmetic value");
+
+      using output_type =
+          reduce_by_key_result_t<Container, Key, Aggregations...>;
+
+      if (container.size() == 0)
+        return output_type{};
+
+      constexpr bool sorted =
+          std::is_same<Strategy, grouping::sort_strategy>::value;
+
+      auto const table = [&]() {
+        if constexpr (sorted)
+          return _f_group_by_sort(policy, container, key, aggregations);
+        else
+          return _f_group_by_hash(policy, container, key, aggregations);
+      }();
+
+      std::vector<size_t> order(table.size());
+      std::iota(order.begin(), order.end(), size_t{0});
+
+      if constexpr (!sorted)
+        std::sort(order.begin(), order.end(), [&table](size_t a, size_t b) {
+          return table.keys()[a] < table.keys()[b];
+        });
+
+      return _f_group_results<output_type>(
+          table, order, std::index_sequence_for<Aggregations...>{});
+    }
+  } // namespace core
+
+  /**
+   * @brief Aggregate the elements of a container with the same key
+   *
+   * The key is computed calling "key" with a constant reference to each
+   * element, and must be an arithmetic value. The result is a
+   * smit::vector of smit::group objects, with the key and the results of
+   * the aggregations (see smit::aggregate) of each group, in increasing
+   * order of the keys.
+   *
+   * Elements are grouped either sorting the keys (smit::grouping::sort),
+   * which suits many different keys, or in hash tables
+   * (smit::grouping::hash), which avoids sorting when there are few of
+   * them. With a parallel policy, each chunk of the elements is aggregated
+   * by a different thread in its own table, and the tables are merged in
+   * the order of the chunks, so the results are reproducible. Sums of
+   * floating point values might still differ from the sequential ones by
+   * rounding.
+   *
+   * @code
+   * auto modules = smit::reduce_by_key(
+   *     smit::execution::par, smit::grouping::hash, hits,
+   *     [](auto const &h) { return h.module(); },
+   *     smit::aggregate::count(),
+   *     smit::aggregate::sum([](auto const &h) { return h.energy(); }));
+   *
+   * for (auto const &m : modules)
+   *   std::cout << m.key() << ' ' << m.value<0>() << '\n';
+   * @endcode
+   */
+  template <
+      class Policy, class Strategy, class Container, class Key,
+      class... Aggregations,
+      class = std::enable_if_t<execution::is_execution_policy_v<Policy> &&
+                               grouping::is_strategy_v<Strategy>>>
+  auto reduce_by_key(Policy &&policy, Strategy strategy,
+                     Container const &container, Key key,
+                     Aggregations... aggregations) {
+    return core::_f_reduce_by_key(policy, strategy, container, key,
+                                  std::make_tuple(std::move(aggregations)...));
+  }
+
+  /// Aggregate the elements of a container with the same key, grouping them
+  /// in hash tables
+  template <class Policy, class Container, class Key, class... Aggregations,
+            class = std::enable_if_t<
+                execution::is_execution_policy_v<Policy> &&
+                core::is_container<Container>::value>>
+  auto reduce_by_key(Policy &&policy, Container const &container, Key key,
+                     Aggregations... aggregations) {
+    return core::_f_reduce_by_key(policy, grouping::hash, container, key,
+                                  std::make_tuple(std::move(aggregations)...));
+  }
+
+  /// Aggregate the elements of a container with the same key, grouping them
+  /// in hash tables, sequentially
+  template <class Container, class Key, class... Aggregations,
+            class = std::enable_if_t<core::is_container<Container>::value>>
+  auto reduce_by_key(Container const &container, Key key,
+                     Aggregations... aggregations) {
+    return core::_f_reduce_by_key(execution::seq, grouping::hash, container,
+                                  key,
+                                  std::make_tuple(std::move(aggregations)...));
+  }
+} // namespace smit
+
+#endif // SMARTIT_AGGREGATE_HPP
@@ -0,0 +1,731 @@
+#ifndef SMARTIT_ALGORITHM_HPP
+#define SMARTIT_ALGORITHM_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "execution.hpp"
+#include "memory.hpp"
+#include "reduction.hpp"
+#include "value.hpp"
+#include "vector.hpp"
+
+namespace smit {
+
+  /**
+   * @brief Apply a function to the elements in [first, last)
+   *
+   * The iterators must be random access. The function is called with the
+   * result of dereferencing them, which for the containers of this library
+   * is a reference returned by value, so it must take it as "auto &&" or
+   * "auto". With a parallel policy, the range is split in contiguous chunks
+   * processed by different threads.
+   */
+  template <class Policy, class Iterator, class Function,
+            class = std::enable_if_t<execution::is_execution_policy_v<Policy>>>
+  void for_each(Policy &&policy, Iterator first, Iterator last, Function f) {
+
+    size_t const size = last - first;
+
+    core::_f_parallel_chunks(
+        size, core::_f_number_of_chunks(policy, size),
+        [&](size_t, size_t begin, size_t end) {
+          for (auto it = first + begin, e = first + end; it != e; ++it)
+            f(*it);
+        });
+  }
+
+  /**
+   * @brief Store the result of applying a function to the elements in
+   * [first, last) in the range starting at "d_first"
+   *
+   * Results are assigned field by field if the output refers to a container
+   * of data objects. Returns the iterator past the last element written.
+   */
+  template <class Policy, class Iterator, class OutputIterator,
+            class Function,
+            class = std::enable_if_t<execution::is_execution_policy_v<Policy>>>
+  OutputIterator transform(Policy &&policy, Iterator first, Iterator last,
+                           OutputIterator d_first, Function f) {
+
+    size_t const size = last - first;
+
+    core::_f_parallel_chunks(
+        size, core::_f_number_of_chunks(policy, size),
+        [&](size_t, size_t begin, size_t end) {
+          auto out = d_first + begin;
+          for (auto it = first + begin, e = first + end; it != e; ++it, ++out)
+            core::_f_assign(*out, f(*it));
+        });
+
+    return d_first + size;
+  }
+
+  /**
+   * @brief Store the result of applying a binary function to the elements
+   * in [first1, last1) and those starting at "first2" in the range starting
+   * at "d_first"
+   */
+  template <class Policy, class Iterator1, class Iterator2,
+            class OutputIterator, class Function,
+            class = std::enable_if_t<execution::is_execution_policy_v<Policy>>>
+  OutputIterator transform(Policy &&policy, Iterator1 first1, Iterator1 last1,
+                           Iterator2 first2, OutputIterator d_first,
+                           Function f) {
+
+    size_t const size = last1 - first1;
+
+    core::_f_parallel_chunks(
+        size, core::_f_number_of_chunks(policy, size),
+        [&](size_t, size_t begin, size_t end) {
+          auto in = first2 + begin;
+          auto out = d_first + begin;
+          for (auto it = first1 + begin, e = first1 + end; it != e;
+               ++it, ++in, ++out)
+            core::_f_assign(*out, f(*it, *in));
+        });
+
+    return d_first + size;
+  }
+
+  /**
+   * @brief Reduce the result of applying a function to the elements in
+   * [first, last)
+   *
+   * The reduction operation must be associative and commutative, since the
+   * elements of each chunk are reduced separately and then combined.
+   */
+  template <class Policy, class Iterator, class T, class Reduce,
+            class Transform,
+            class = std::enable_if_t<execution::is_execution_policy_v<Policy>>>
+  T transform_reduce(Policy &&policy, Iterator first, Iterator last, T init,
+                     Reduce reduce, Transform transform) {
+
+    size_t const size = last - first;
+    size_t const chunks = core::_f_number_of_chunks(policy, size);
+
+    std::vector<std::optional<T>> partial(chunks);
+
+    core::_f_parallel_chunks(size, chunks,
+                             [&](size_t c, size_t begin, size_t end) {
+                               auto it = first + begin;
+                               T r = transform(*it);
+                               for (auto e = first + end; ++it != e;)
+                                 r = reduce(r, transform(*it));
+                               partial[c] = std::move(r);
+                             });
+
+    for (auto &p : partial)
+      if (p)
+        init = reduce(init, *p);
+
+    return init;
+  }
+
+  /**
+   * @brief Reduce the elements in [first, last)
+   *
+   * Elements of containers of data objects are copied to their value type
+   * before being reduced.
+   *
+   * @see smit::transform_reduce
+   */
+  template <class Policy, class Iterator, class T, class Reduce,
+            class = std::enable_if_t<execution::is_execution_policy_v<Policy>>>
+  T reduce(Policy &&policy, Iterator first, Iterator last, T init,
+           Reduce reduce) {
+    return smit::transform_reduce(
+        policy, first, last, std::move(init), reduce,
+        [](auto const &e) -> T { return core::_f_to_value(e); });
+  }
+
+  namespace core {
+
+    /**
+     * @brief Sort the range [first, last)
+     *
+     * With a parallel policy, the chunks of the range are sorted by
+     * different threads, and then merged pairwise, so the result is the
+     * same as that of the sequential sort. Merging preserves the order of
+     * equivalent elements.
+     */
+    template <bool Stable, class Policy, class Iterator, class Compare>
+    inline void _f_sort(Policy const &policy, Iterator first, Iterator last,
+                        Compare comp) {
+
+      auto sort = [comp](Iterator b, Iterator e) {
+        if constexpr (Stable)
+          std::stable_sort(b, e, comp);
+        else
+          std::sort(b, e, comp);
+      };
+
+      size_t const size = last - first;
+      size_t const chunks = _f_number_of_chunks(policy, size);
+
+      if (chunks <= 1) {
+        sort(first, last);
+        return;
+      }
+
+      // the thread pool might use less chunks than requested
+      std::vector<size_t> bounds(chunks + 1, size);
+      _f_parallel_chunks(size, chunks, [&](size_t c, size_t b, size_t e) {
+        bounds[c] = b;
+        sort(first + b, first + e);
+      });
+      bounds.erase(std::unique(bounds.begin(), bounds.end()), bounds.end());
+
+      // merge consecutive pairs of sorted runs until a single one is left
+      while (bounds.size() > 2) {
+
+        size_t const pairs = (bounds.size() - 1) / 2;
+
+        // each pair is a separate task, since chunks of pairs would be
+        // rounded to the granularity of the columns
+        _f_parallel_tasks(pairs, [&](size_t p) {
+          std::inplace_merge(first + bounds[2 * p], first + bounds[2 * p + 1],
+                             first + bounds[2 * p + 2], comp);
+        });
+
+        std::vector<size_t> merged;
+        for (size_t k = 0; k < bounds.size(); k += 2)
+          merged.push_back(bounds[k]);
+        if (merged.back() != size)
+          merged.push_back(size);
+
+        bounds = std::move(merged);
+      }
+    }
+
+    /**
+     * @brief Reorder the elements of a container, so the element at
+     * position i is the one that was at position "permutation[i]"
+     *
+     * Each column is gathered in a scratch buffer, shared by all of them,
+     * and copied back, processing chunks of the column in parallel with
+     * the parallel policies.
+     */
+    template <class Policy, class Container>
+    inline void _f_apply_permutation(Policy const &policy,
+                                     Container &container,
+                                     std::vector<size_t> const &permutation) {
+
+      size_t const size = permutation.size();
+      size_t const chunks = _f_number_of_chunks(policy, size);
+
+      std::vector<__cache_line> scratch(
+          _f_cache_lines<unsigned char>(
+              size * _f_max_field_size<typename Container::value_type>()));
+
+      _f_for_each_column(
+          [&](auto &column) {
+            using type = std::remove_reference_t<decltype(column[0])>;
+
+            auto buffer = reinterpret_cast<type *>(scratch.data());
+
+            _f_parallel_chunks(size, chunks, [&](size_t, size_t b, size_t e) {
+              for (size_t i = b; i < e; ++i)
+                buffer[i] = column[permutation[i]];
+            });
+            _f_parallel_chunks(size, chunks, [&](size_t, size_t b, size_t e) {
+              for (size_t i = b; i < e; ++i)
+                column[i] = buffer[i];
+            });
+          },
+          _f_columns(container));
+    }
+
+    /// Number of elements whose positions are selected at once when
+    /// compacting containers, stored as offsets in a local buffer
+    constexpr size_t compaction_block = 1u << 12;
+
+    /**
+     * @brief Write the offsets from "first" of the elements in [first, last)
+     * of a container satisfying a predicate, in increasing order, returning
+     * how many there are
+     *
+     * The predicate is evaluated on constant batches of the elements, and
+     * returns a smit::simd::mask. The offsets are appended without
+     * branches, so the cost does not depend on the fraction of elements
+     * selected. The output must have room for last - first offsets.
+     */
+    template <class Container, class Predicate>
+    inline size_t _f_select(Container const &container, Predicate &pred,
+                            size_t first, size_t last,
+                            std::uint32_t *selection) {
+
+      constexpr size_t W =
+          batch_width<typename Container::value_type, Container>;
+
+      size_t k = 0;
+
+      _f_for_each_batch_in<W>(
+          first, last,
+          [&](size_t index, size_t n, auto const &batch) {
+            using mask_type = std::decay_t<decltype(pred(batch))>;
+
+            auto const bits = (pred(batch) & mask_type::first(n)).bits();
+
+            for (size_t l = 0; l < n; ++l) {
+              selection[k] = std::uint32_t(index - first + l);
+              k += (bits >> l) & 1u;
+            }
+          },
+          container);
+
+      return k;
+    }
+
+    /**
+     * @brief Copy the elements of the input at the positions
+     * base + indices[j] to the positions first + j of the output, for j in
+     * [0, n)
+     *
+     * Columns are processed one after the other, in a single pass over the
+     * positions, prefetching the elements a few positions ahead. If the
+     * input and the output are the same, the positions read must be
+     * increasing and not smaller than those written.
+     */
+    template <class Input, class Output, class Index>
+    inline void _f_gather(Input const &input, Output &output,
+                          Index const *indices, size_t n, size_t first = 0,
+                          size_t base = 0) {
+      _f_for_each_column(
+          [indices, n, first, base](auto &out, auto const &in) {
+            size_t j = 0;
+            for (; j + prefetch_distance < n; ++j) {
+              _f_prefetch(&in[base + indices[j + prefetch_distance]]);
+              out[first + j] = in[base + indices[j]];
+            }
+            for (; j < n; ++j)
+              out[first + j] = in[base + indices[j]];
+          },
+          _f_columns(output), _f_columns(input));
+    }
+
+    /**
+     * @brief Copy the elements of the input satisfying a predicate to the
+     * beginning of the output, keeping their order, and return how many
+     * there are
+     *
+     * The input is processed in blocks of smit::core::compaction_block
+     * elements, selecting the offsets of the elements of each block in a
+     * local buffer and copying them before the next one, so no memory is
+     * allocated for the positions. If InPlace is true, the output is the
+     * input itself, which is safe since elements are never written after
+     * the position they are read from. Otherwise the output is resized as
+     * the elements are copied.
+     */
+    template <bool InPlace, class Input, class Output, class Predicate>
+    inline size_t _f_compact(Input const &input, Output &output,
+                             Predicate &pred) {
+
+      std::uint32_t offsets[compaction_block];
+
+      size_t const size = input.size();
+
+      size_t k = 0;
+      for (size_t b = 0; b < size; b += compaction_block) {
+
+        size_t const e = std::min(b + compaction_block, size);
+        size_t const n = _f_select(input, pred, b, e, offsets);
+
+        if constexpr (InPlace) {
+          // the elements before the first removed one stay in place
+          if (k == b && n == e - b) {
+            k += n;
+            continue;
+          }
+        } else
+          output.resize(k + n);
+
+        _f_gather(input, output, offsets, n, k, b);
+
+        k += n;
+      }
+
+      return k;
+    }
+
+    /// Copy the elements in [0, size) of the input to the positions
+    /// indices[j] of the output, column by column
+    template <class Input, class Output, class Index>
+    inline void _f_scatter(Input const &input, Output &output,
+                           Index const *indices, size_t size) {
+      _f_for_each_column(
+          [indices, size](auto &out, auto const &in) {
+            size_t j = 0;
+            for (; j + prefetch_distance < size; ++j) {
+              _f_prefetch<true>(&out[indices[j + prefetch_distance]]);
+              out[indices[j]] = in[j];
+            }
+            for (; j < size; ++j)
+              out[indices[j]] = in[j];
+          },
+          _f_columns(output), _f_columns(input));
+    }
+
+    /// Call a function on the columns of the fields at positions I...
+    /// (nested data objects as a whole), or on all of them if no position
+    /// is given
+    template <size_t... I, class Function, class... Columns>
+    inline void _f_for_each_selected_column(Function &f,
+                                            Columns &... columns) {
+      if constexpr (sizeof...(I) == 0)
+        _f_for_each_column(f, columns...);
+      else
+        (_f_for_each_column_of<I>(f, columns...), ...);
+    }
+
+    /// Write the prefix sums of the values in [in, in + n), starting from
+    /// "init", to [out, out + n). The input and the output can be the same.
+    template <bool Inclusive, class T>
+    inline void _f_prefix_sum(T const *in, T *out, size_t n, T init) {
+      for (size_t i = 0; i < n; ++i) {
+        T const value = in[i];
+        if constexpr (Inclusive) {
+          init += value;
+          out[i] = init;
+        } else {
+          out[i] = init;
+          init += value;
+        }
+      }
+    }
+
+    /**
+     * @brief Write the prefix sums of the selected fields of a container to
+     * the same fields of another container, which can be the same
+     *
+     * With the sequential policy each column is scanned in a single pass.
+     * With a parallel policy, the sums of the chunks of the column are computed
+     * first, and then each chunk is scanned by a different thread starting
+     * from the sum of the previous ones.
+     */
+    template <bool Inclusive, size_t... I, class Policy, class Input,
+              class Output>
+    inline void _f_scan(Policy const &policy, Input const &input,
+                        Output &output) {
+
+      size_t const size = input.size();
+      size_t const chunks = _f_number_of_chunks(policy, size);
+
+      auto scan = [&](auto &out, auto const &in) {
+        using type = column_value_t<std::decay_t<decltype(in)>>;
+
+        auto const src = _f_column_data(in);
+        auto const dst = _f_column_data(out);
+
+        if (chunks <= 1) {
+          _f_prefix_sum<Inclusive>(src, dst, size, type(0));
+          return;
+        }
+
+        std::vector<type> offsets(chunks, type(0));
+
+        _f_parallel_chunks(size, chunks, [&](size_t c, size_t b, size_t e) {
+          offsets[c] = _f_sum(summation::simple, src + b, e - b);
+        });
+
+        _f_prefix_sum<false>(offsets.data(), offsets.data(), chunks,
+                             type(0));
+
+        _f_parallel_chunks(size, chunks, [&](size_t c, size_t b, size_t e) {
+          _f_prefix_sum<Inclusive>(src + b, dst + b, e - b, offsets[c]);
+        });
+      };
+
+      _f_for_each_selected_column<I...>(scan, _f_columns(output),
+                                        _f_columns(input));
+    }
+
+    /// Sort the elements of a container by the value of a key
+    template <bool Stable, class Policy, class Container, class Key,
+              class Compare>
+    inline void _f_sort_by_key(Policy const &policy, Container &container,
+                               Key &key, Compare &comp) {
+
+      using key_type = std::decay_t<decltype(key(std::as_const(container)[0]))>;
+      using entry_type = std::pair<key_type, size_t>;
+
+      size_t const size = container.size();
+      size_t const chunks = _f_number_of_chunks(policy, size);
+
+      // the keys are stored with the positions, so they are accessed
+      // contiguously while sorting
+      std::vector<entry_type> entries(size);
+
+      _f_parallel_chunks(size, chunks, [&](size_t, size_t b, size_t e) {
+        for (size_t i = b; i < e; ++i)
+          entries[i] = {key(std::as_const(container)[i]), i};
+      });
+
+      _f_sort<Stable>(policy, entries.begin(), entries.end(),
+                      [&comp](entry_type const &a, entry_type const &b) {
+                        return comp(a.first, b.first);
+                      });
+
+      std::vector<size_t> permutation(size);
+      for (size_t i = 0; i < size; ++i)
+        permutation[i] = entries[i].second;
+
+      entries = {};
+
+      _f_apply_permutation(policy, container, permutation);
+    }
+  } // namespace core
+
+  /**
+   * @brief Sort the elements of a container by the value of a key
+   *
+   * The key is computed once per element, calling "key" with a constant
+   * reference to it, and the keys are sorted together with the positions
+   * of the elements. The resulting permutation is then applied to each
+   * column of the container, so the values are moved column by column.
+   * The order of elements with equivalent keys is unspecified.
+   *
+   * @code
+   * smit::sort(smit::execution::par, hits,
+   *            [](auto const &h) { return h.detector(); });
+   * @endcode
+   */
+  template <class Policy, class Container, class Key,
+            class Compare = std::less<>,
+            class = std::enable_if_t<execution::is_execution_policy_v<Policy>>>
+  void sort(Policy &&policy, Container &container, Key key,
+            Compare comp = {}) {
+    core::_f_sort_by_key<false>(policy, container, key, comp);
+  }
+
+  /// Sort the elements of a container by the value of a key, sequentially
+  template <class Container, class Key, class Compare = std::less<>,
+            class = std::enable_if_t<core::is_container<Container>::value>>
+  void sort(Container &container, Key key, Compare comp = {}) {
+    core::_f_sort_by_key<false>(execution::seq, container, key, comp);
+  }
+
+  /**
+   * @brief Sort the elements of a container by the value of a key,
+   * preserving the order of elements with equivalent keys
+   *
+   * @see smit::sort
+   */
+  template <class Policy, class Container, class Key,
+            class Compare = std::less<>,
+            class = std::enable_if_t<execution::is_execution_policy_v<Policy>>>
+  void stable_sort(Policy &&policy, Container &container, Key key,
+                   Compare comp = {}) {
+    core::_f_sort_by_key<true>(policy, container, key, comp);
+  }
+
+  /// Sort the elements of a container by the value of a key, preserving
+  /// the order of elements with equivalent keys, sequentially
+  template <class Container, class Key, class Compare = std::less<>,
+            class = std::enable_if_t<core::is_container<Container>::value>>
+  void stable_sort(Container &container, Key key, Compare comp = {}) {
+    core::_f_sort_by_key<true>(execution::seq, container, key, comp);
+  }
+
+  /**
+   * @brief Remove the elements of a container satisfying a predicate,
+   * keeping the order of the rest, and return how many were removed
+   *
+   * The predicate is called on constant batches of elements (see
+   * smit::simd::batch), and must return a smit::simd::mask with the lanes
+   * of the elements to remove set. Inactive lanes are ignored. The
+   * elements are processed in blocks, moving those kept in each block
+   * column by column, so no memory is allocated.
+   *
+   * @code
+   * smit::erase_if(points, [r2](auto const &b) { return b.mod2() > r2; });
+   * @endcode
+   */
+  template <class Container, class Predicate>
+  size_t erase_if(Container &container, Predicate pred) {
+
+    size_t const size = container.size();
+
+    auto keep = [&pred](auto const &batch) { return !pred(batch); };
+
+    size_t const kept = core::_f_compact<true>(container, container, keep);
+
+    container.resize(kept);
+
+    return size - kept;
+  }
+
+  /**
+   * @brief Copy the elements of a container satisfying a predicate to
+   * another container, keeping their order, and return how many there are
+   *
+   * The output is resized to the number of elements selected, growing as
+   * they are copied, so reserving it beforehand avoids any allocation. The
+   * predicate is called on constant batches of elements and returns a
+   * smit::simd::mask with the lanes of the elements to copy set.
+   *
+   * @see smit::erase_if
+   */
+  template <class Input, class Output, class Predicate>
+  size_t filter(Input const &input, Output &output, Predicate pred) {
+    output.resize(0);
+    return core::_f_compact<false>(input, output, pred);
+  }
+
+  /**
+   * @brief Build a container with the elements of another satisfying a
+   * predicate, keeping their order
+   *
+   * @see smit::filter
+   */
+  template <class Container, class Predicate>
+  Container filter(Container const &container, Predicate pred) {
+    Container output;
+    smit::filter(container, output, std::move(pred));
+    return output;
+  }
+
+  /**
+   * @brief Copy the elements of a container at the given positions to
+   * another container, resizing it to the number of positions
+   *
+   * The positions are any contiguous range of integers (std::vector,
+   * std::array...), and can be repeated. They are not checked. Each column
+   * is copied in a single pass over the positions.
+   */
+  template <class Input, class Indices, class Output>
+  void take(Input const &input, Indices const &indices, Output &output) {
+    size_t const size = std::size(indices);
+    output.resize(size);
+    core::_f_gather(input, output, std::data(indices), size);
+  }
+
+  /**
+   * @brief Build a container with the elements of another at the given
+   * positions
+   *
+   * @see smit::take
+   */
+  template <class Container, class Indices>
+  Container take(Container const &container, Indices const &indices) {
+    Container output;
+    smit::take(container, indices, output);
+    return output;
+  }
+
+  /**
+   * @brief Copy the elements of "values" to the given positions of a
+   * container
+   *
+   * There must be as many positions as values, and the positions must be
+   * valid, which is not checked. If a position is repeated, the last value
+   * is kept. Each column is copied in a single pass over the positions.
+   */
+  template <class Container, class Indices, class Values>
+  void scatter(Container &container, Indices const &indices,
+               Values const &values) {
+    core::_f_scatter(values, container, std::data(indices),
+                     std::size(indices));
+  }
+
+  /**
+   * @brief Write the inclusive prefix sums of the fields of a container to
+   * another container, resizing it
+   *
+   * If field positions are given, only the columns of those fields (all
+   * the columns of nested data objects) are scanned, and the rest of the
+   * fields of the output are not modified. Columns are scanned through
+   * their raw values, so containers must store them contiguously
+   * (smit::vector, smit::array and smit::mmap_vector). With a parallel
+   * policy each column is processed in two passes over blocks of elements,
+   * and the result for floating point values can differ by rounding from
+   * the sequential one, though it does not depend on the number of
+   * threads.
+   *
+   * @code
+   * smit::inclusive_scan<0>(smit::execution::par, points, cumulative);
+   * @endcode
+   */
+  template <size_t... I, class Policy, class Input, class Output,
+            class = std::enable_if_t<execution::is_execution_policy_v<Policy>>>
+  void inclusive_scan(Policy &&policy, Input const &input, Output &output) {
+    output.resize(input.size());
+    core::_f_scan<true, I...>(policy, input, output);
+  }
+
+  /// Replace the fields of the elements of a container by their inclusive
+  /// prefix sums
+  template <size_t... I, class Policy, class Container,
+            class = std::enable_if_t<execution::is_execution_policy_v<Policy>>>
+  void inclusive_scan(Policy &&policy, Container &container) {
+    core::_f_scan<true, I...>(policy, container, container);
+  }
+
+  /// Write the inclusive prefix sums of the fields of a container to
+  /// another container, sequentially
+  template <size_t... I, class Input, class Output,
+            class = std::enable_if_t<core::is_container<Input>::value>>
+  void inclusive_scan(Input const &input, Output &output) {
+    output.resize(input.size());
+    core::_f_scan<true, I...>(execution::seq, input, output);
+  }
+
+  /// Replace the fields of the elements of a container by their inclusive
+  /// prefix sums, sequentially
+  template <size_t... I, class Container,
+            class = std::enable_if_t<core::is_container<Container>::value>>
+  void inclusive_scan(Container &container) {
+    core::_f_scan<true, I...>(execution::seq, container, container);
+  }
+
+  /**
+   * @brief Write the exclusive prefix sums of the fields of a container to
+   * another container, resizing it
+   *
+   * The first element of the output is zero, and the element at position i
+   * is the sum of the elements before i in the input, which is what is
+   * needed to compute the offsets of variable-length groups from their
+   * sizes.
+   *
+   * @see smit::inclusive_scan
+   */
+  template <size_t... I, class Policy, class Input, class Output,
+            class = std::enable_if_t<execution::is_execution_policy_v<Policy>>>
+  void exclusive_scan(Policy &&policy, Input const &input, Output &output) {
+    output.resize(input.size());
+    core::_f_scan<false, I...>(policy, input, output);
+  }
+
+  /// Replace the fields of the elements of a container by their exclusive
+  /// prefix sums
+  template <size_t... I, class Policy, class Container,
+            class = std::enable_if_t<execution::is_execution_policy_v<Policy>>>
+  void exclusive_scan(Policy &&policy, Container &container) {
+    core::_f_scan<false, I...>(policy, container, container);
+  }
+
+  /// Write the exclusive prefix sums of the fields of a container to
+  /// another container, sequentially
+  template <size_t... I, class Input, class Output,
+            class = std::enable_if_t<core::is_container<Input>::value>>
+  void exclusive_scan(Input const &input, Output &output) {
+    output.resize(input.size());
+    core::_f_scan<false, I...>(execution::seq, input, output);
+  }
+
+  /// Replace the fields of the elements of a container by their exclusive
+  /// prefix sums, sequentially
+  template <size_t... I, class Container,
+            class = std::enable_if_t<core::is_container<Container>::value>>
+  void exclusive_scan(Container &container) {
+    core::_f_scan<false, I...>(execution::seq, container, container);
+  }
+} // namespace smit
+
+#endif // SMARTIT_ALGORITHM_HPP
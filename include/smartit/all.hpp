@@ -1,9 +1,28 @@
 #ifndef SMARTIT_ALL_HPP
 #define SMARTIT_ALL_HPP
 
+#include "aggregate.hpp"
+#include "algorithm.hpp"
 #include "array.hpp"
+#include "arena.hpp"
+#include "arrow.hpp"
+#include "container.hpp"
+#include "execution.hpp"
+#include "expression.hpp"
+#include "format.hpp"
 #include "iterator.hpp"
+#include "kernels.hpp"
+#include "layout.hpp"
+#include "memory.hpp"
+#include "mmap_vector.hpp"
+#include "projection.hpp"
+#include "reduction.hpp"
+#include "simd.hpp"
+#include "small_vector.hpp"
+#include "stream.hpp"
 #include "test.hpp"
+#include "thread_pool.hpp"
+#include "tiled_vector.hpp"
 #include "traits.hpp"
 #include "types.hpp"
 #include "utils.hpp"
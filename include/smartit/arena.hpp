@@ -0,0 +1,178 @@
+#ifndef SMARTIT_ARENA_HPP
+#define SMARTIT_ARENA_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+#include "memory.hpp"
+
+namespace smit {
+
+  /**
+   * @brief Monotonic memory region
+   *
+   * Memory is handed out sequentially from blocks allocated on demand, and
+   * it is never released individually. Resetting the arena makes all the
+   * memory available again in constant time, keeping the blocks for the
+   * following allocations, so containers created and destroyed repeatedly
+   * (e.g. once per event) do not call the system allocator once the arena
+   * is warm. The containers using the arena must be destroyed, or not
+   * accessed anymore, before it is reset.
+   *
+   * @see smit::arena_allocator
+   */
+  class arena {
+
+  public:
+    /// Build the arena, allocating blocks of at least the given size (in
+    /// bytes) when needed
+    explicit arena(size_t block_size = 1u << 20)
+        : m_block_size{std::max<size_t>(block_size, core::cache_line_size)} {}
+
+    arena(arena const &) = delete;
+    arena &operator=(arena const &) = delete;
+
+    /// Release the blocks
+    ~arena() {
+      for (auto &b : m_blocks)
+        ::operator delete(b.data, std::align_val_t{core::cache_line_size});
+    }
+
+    /// Get a memory region with the given size and alignment, which must be
+    /// a power of two
+    void *allocate(size_t bytes, size_t alignment) {
+
+      alignment = std::max<size_t>(alignment, 1);
+
+      for (; m_current < m_blocks.size(); ++m_current, m_offset = 0) {
+
+        auto &b = m_blocks[m_current];
+
+        // the address, and not only the offset, must be aligned
+        auto const address = reinterpret_cast<std::uintptr_t>(b.data);
+        size_t const start =
+            ((address + m_offset + alignment - 1) & ~(alignment - 1)) -
+            address;
+
+        if (start <= b.size && bytes <= b.size - start) {
+          m_offset = start + bytes;
+          return b.data + start;
+        }
+      }
+
+      // blocks are aligned to a cache line, so larger alignments need room
+      // to be adjusted
+      size_t const extra =
+          alignment > core::cache_line_size ? alignment : 0;
+      size_t const size = std::max(m_block_size, bytes + extra);
+
+      auto data = static_cast<unsigned char *>(::operator new(
+          size, std::align_val_t{core::cache_line_size}));
+      m_blocks.push_back({data, size});
+      m_capacity += size;
+
+      m_current = m_blocks.size() - 1;
+      m_offset = 0;
+
+      return this->allocate(bytes, alignment);
+    }
+
+    /// Make all the memory available again
+    void reset() {
+      m_current = 0;
+      m_offset = 0;
+    }
+
+    /// Total size of the blocks (in bytes)
+    size_t capacity() const { return m_capacity; }
+
+    /// Number of blocks
+    size_t number_of_blocks() const { return m_blocks.size(); }
+
+  private:
+    /// Block of memory
+    struct block {
+      unsigned char *data;
+      size_t size;
+    };
+
+    /// Minimum size of the blocks
+    size_t m_block_size;
+    /// Blocks
+    std::vector<block> m_blocks;
+    /// Block where the next allocation is attempted
+    size_t m_current = 0;
+    /// Position of the free memory in the current block
+    size_t m_offset = 0;
+    /// Total size of the blocks
+    size_t m_capacity = 0;
+  };
+
+  /**
+   * @brief Allocator serving the memory from a smit::arena
+   *
+   * Deallocation does nothing, the memory being recovered when the arena is
+   * reset. Default-constructed allocators do not refer to any arena and
+   * throw std::bad_alloc when used, so containers must be built with an
+   * allocator instance:
+   *
+   * @code
+   * smit::arena a;
+   * smit::vector<smit::point_3d<float>, smit::arena_allocator> v{a};
+   * @endcode
+   */
+  template <class T> class arena_allocator {
+
+  public:
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    /// Allocator not referring to any arena
+    arena_allocator() noexcept = default;
+
+    /// Build the allocator from an arena
+    arena_allocator(arena &a) noexcept : m_arena{&a} {}
+
+    /// Build the allocator from one for another type
+    template <class U>
+    arena_allocator(arena_allocator<U> const &other) noexcept
+        : m_arena{other.get_arena()} {}
+
+    /// Allocate memory for n objects
+    T *allocate(size_t n) {
+      if (m_arena == nullptr)
+        throw std::bad_alloc{};
+      return static_cast<T *>(m_arena->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    /// Memory is only recovered when the arena is reset
+    void deallocate(T *, size_t) noexcept {}
+
+    /// Arena serving the memory
+    arena *get_arena() const noexcept { return m_arena; }
+
+  private:
+    /// Arena serving the memory
+    arena *m_arena = nullptr;
+  };
+
+  /// Comparison operator (equality)
+  template <class T, class U>
+  bool operator==(arena_allocator<T> const &a, arena_allocator<U> const &b) {
+    return a.get_arena() == b.get_arena();
+  }
+
+  /// Comparison operator (inequality)
+  template <class T, class U>
+  bool operator!=(arena_allocator<T> const &a, arena_allocator<U> const &b) {
+    return !(a == b);
+  }
+} // namespace smit
+
+#endif // SMARTIT_ARENA_HPP
@@ -3,93 +3,121 @@
 
 #include <array>
 
+#include "expression.hpp"
 #include "iterator.hpp"
+#include "simd.hpp"
 
 namespace smit {
 
   // Forward declaration of the array class
-  template <class Object, size_t N> class array;
+  template <class Object, size_t N, size_t Alignment = 1> class array;
 
   namespace core {
-    /// Proxy for an array storing its type and iterator
-    template <class Type, size_t N, class Enable = void>
+    /**
+     * @brief Column of an array aligned to the given number of bytes
+     *
+     * Its size is rounded up to a multiple of the alignment, so the column
+     * is padded to the next aligned address.
+     */
+    template <class Type, size_t N, size_t Alignment>
+    struct alignas(Alignment) __aligned_array : std::array<Type, N> {};
+
+    /// Proxy for an array, storing the type of the column of a field
+    template <class Type, size_t N, size_t Alignment, class Enable = void>
     struct array_proxy {}; // primary template
 
-    template <class Type, size_t N>
+    template <class Type, size_t N, size_t Alignment>
     struct array_proxy<
-        Type, N,
+        Type, N, Alignment,
         typename std::enable_if<std::is_arithmetic<Type>::value>::type> {
-      using type = std::array<Type, N>;
-      using iterator = typename type::iterator;
+      using type = std::conditional_t<(Alignment > alignof(Type)),
+                                      __aligned_array<Type, N, Alignment>,
+                                      std::array<Type, N>>;
     };
 
-    template <class Type, size_t N>
+    template <class Type, size_t N, size_t Alignment>
     struct array_proxy<
-        Type, N,
+        Type, N, Alignment,
         typename std::enable_if<!std::is_arithmetic<Type>::value>::type> {
-      using type = array<Type, N>;
-      using iterator = typename type::iterator;
+      using type = array<Type, N, Alignment>;
     };
 
-    template <class Type, size_t N>
-    using array_proxy_t = typename array_proxy<Type, N>::type;
+    template <class Type, size_t N, size_t Alignment>
+    using array_proxy_t = typename array_proxy<Type, N, Alignment>::type;
 
     // Auxiliar function to determine the array type
-    template <size_t N, class... Types>
+    template <size_t N, size_t Alignment, class... Types>
     constexpr auto _f_array_base(utils::types_holder<Types...>) {
-      return utils::type_wrapper<std::tuple<array_proxy_t<Types, N>...>>{};
+      return utils::type_wrapper<
+          std::tuple<array_proxy_t<Types, N, Alignment>...>>{};
     }
 
     /// Container of the base type for array objects
-    template <class H, size_t N> struct array_base {
-      using type = typename decltype(_f_array_base<N>(H{}))::type;
+    template <class H, size_t N, size_t Alignment> struct array_base {
+      using type = typename decltype(_f_array_base<N, Alignment>(H{}))::type;
     };
 
     /// Base type for array objects
-    template <class H, size_t N>
-    using array_base_t = typename array_base<H, N>::type;
-
-    template <size_t N> struct sized_array_proxy {
-      template <class Type> using type = array_proxy_t<Type, N>;
-    };
+    template <class H, size_t N, size_t Alignment>
+    using array_base_t = typename array_base<H, N, Alignment>::type;
   } // namespace core
 
   /**
    * @brief Definition of an array based on the std::array class
+   *
+   * The columns are aligned to at least the given number of bytes, which
+   * must be a power of two, and padded to a multiple of it. By default
+   * they have the alignment of their types.
    */
-  template <class Object, size_t N>
-  class array : public core::array_base_t<typename Object::types, N> {
+  template <class Object, size_t N, size_t Alignment>
+  class array
+      : public core::array_base_t<typename Object::types, N, Alignment> {
+
+    static_assert(Alignment != 0 && (Alignment & (Alignment - 1)) == 0,
+                  "The alignment must be a power of two");
 
   public:
-    using base_class = core::array_base_t<typename Object::types, N>;
-    using iterator =
-        core::__iterator<core::sized_array_proxy<N>::template type, Object>;
-    using const_iterator =
-        core::__const_iterator<core::sized_array_proxy<N>::template type,
-                               Object>;
+    using base_class =
+        core::array_base_t<typename Object::types, N, Alignment>;
+    /// Alignment (in bytes) of the first element of each column
+    static constexpr size_t column_alignment = Alignment;
+    /// Type of the elements
+    using value_type = Object;
+    using iterator = core::__iterator<base_class, Object>;
+    using const_iterator = core::__const_iterator<base_class, Object>;
+    /// Type of the container returned on access
+    using reference = typename iterator::reference;
+    /// Type of the container returned on access (constant)
+    using const_reference = typename const_iterator::reference;
+    /// Type of the distance between iterators
+    using difference_type = typename iterator::difference_type;
     /// Default constructor
     array() : base_class{} {}
     /// Destructor
     ~array() {}
 
-    inline typename iterator::value_type &operator[](size_t i) {
-      return this->at(i);
+    /// Evaluate an expression, storing the result in the array. The
+    /// expression must have the same size as the array.
+    template <class Expression,
+              class = std::enable_if_t<core::is_expression<Expression>::value>>
+    array &operator=(Expression const &expression) {
+      core::_f_evaluate<column_alignment>(
+          expression, static_cast<base_class &>(*this), this->size());
+      return *this;
     }
 
-    inline typename iterator::value_type const &operator[](size_t i) const {
-      return this->at(i);
-    }
+    inline reference operator[](size_t i) { return this->at(i); }
+
+    inline const_reference operator[](size_t i) const { return this->at(i); }
 
-    /// Returns a reference at position i in the vector
-    typename iterator::value_type &at(size_t i) {
-      return this->at_impl(
-          i, std::make_index_sequence<Object::number_of_fields>{});
+    /// Returns a reference at position i in the array
+    reference at(size_t i) {
+      return reference(static_cast<base_class &>(*this), i);
     }
 
-    /// Returns a reference at position i in the vector (constant)
-    typename iterator::value_type const &at(size_t i) const {
-      return this->at_impl(
-          i, std::make_index_sequence<Object::number_of_fields>{});
+    /// Returns a reference at position i in the array (constant)
+    const_reference at(size_t i) const {
+      return const_reference(static_cast<base_class const &>(*this), i);
     }
 
     /// Get the size of the array
@@ -101,82 +129,57 @@ namespace smit {
         return N;
     }
 
-    /// Begining of the array
-    auto begin() {
-      return this->begin_impl(
-          std::make_index_sequence<Object::number_of_fields>{});
+    /// Call a function on batches of W consecutive elements. The function
+    /// receives a smit::simd::batch and, optionally, the number of active
+    /// lanes. The last batch is masked if the size is not a multiple of W.
+    template <size_t W = simd::default_width<Object>, class Function>
+    void for_each_batch(Function &&f) {
+      core::_f_for_each_batch<W, Object, Alignment>(
+          static_cast<base_class &>(*this), this->size(), f);
     }
 
-    /// Begining of the array (constant)
-    auto begin() const {
-      return this->cbegin_impl(
-          std::make_index_sequence<Object::number_of_fields>{});
+    /// Call a function on batches of W consecutive elements (constant). The
+    /// batches are not stored back in the array.
+    template <size_t W = simd::default_width<Object>, class Function>
+    void for_each_batch(Function &&f) const {
+      core::_f_for_each_batch<W, Object, Alignment>(
+          static_cast<base_class const &>(*this), this->size(), f);
     }
 
-    /// Begining of the array (constant)
-    auto cbegin() const {
-      return this->cbegin_impl(
-          std::make_index_sequence<Object::number_of_fields>{});
-    }
-
-    /// End of the array
-    auto end() {
-      return this->end_impl(
-          std::make_index_sequence<Object::number_of_fields>{});
-    }
-
-    /// End of the array (constant)
-    auto end() const {
-      return this->cend_impl(
-          std::make_index_sequence<Object::number_of_fields>{});
-    }
-
-    /// End of the array (constant)
-    auto cend() const {
-      return this->cend_impl(
-          std::make_index_sequence<Object::number_of_fields>{});
+    /// Pointer to the column of an arithmetic field, given by its position
+    /// and, for nested data objects, those of the fields inside them
+    template <size_t... I> auto data() {
+      return core::_f_assume_aligned<Alignment>(core::_f_column_data(
+          core::_f_column<I...>(static_cast<base_class &>(*this))));
     }
 
-  private:
-    /// Implementation of the at function
-    template <size_t... I>
-    typename iterator::value_type &at_impl(size_t i,
-                                           std::index_sequence<I...>) {
-      return *(this->begin() + i);
+    /// Pointer to the column of an arithmetic field (constant)
+    template <size_t... I> auto data() const {
+      return core::_f_assume_aligned<Alignment>(core::_f_column_data(
+          core::_f_column<I...>(static_cast<base_class const &>(*this))));
     }
 
-    /// Implementation of the at function (constant)
-    template <size_t... I>
-    typename iterator::value_type const &
-    at_impl(size_t i, std::index_sequence<I...>) const {
-      return *(this->cbegin() + i);
-    }
-
-    /// Implementation of the begining function
-    template <size_t... I> iterator begin_impl(std::index_sequence<I...>) {
-
-      return {std::begin(std::get<I>(*this))...};
-    };
-
-    /// Implementation of the begining function (constant)
-    template <size_t... I>
-    const_iterator cbegin_impl(std::index_sequence<I...>) const {
+    /// Begining of the array
+    iterator begin() { return {*this, 0}; }
 
-      return {std::cbegin(std::get<I>(*this))...};
-    };
+    /// Begining of the array (constant)
+    const_iterator begin() const { return {*this, 0}; }
 
-    /// Implementation of the end function
-    template <size_t... I> iterator end_impl(std::index_sequence<I...>) {
+    /// Begining of the array (constant)
+    const_iterator cbegin() const { return {*this, 0}; }
 
-      return {std::end(std::get<I>(*this))...};
-    };
+    /// End of the array
+    iterator end() { return {*this, difference_type(this->size())}; }
 
-    /// Implementation of the end function (constant)
-    template <size_t... I>
-    const_iterator cend_impl(std::index_sequence<I...>) const {
+    /// End of the array (constant)
+    const_iterator end() const {
+      return {*this, difference_type(this->size())};
+    }
 
-      return {std::cend(std::get<I>(*this))...};
-    };
+    /// End of the array (constant)
+    const_iterator cend() const {
+      return {*this, difference_type(this->size())};
+    }
   };
 } // namespace smit
 
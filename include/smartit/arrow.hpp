@@ -0,0 +1,437 @@
+#ifndef SMARTIT_ARROW_HPP
+#define SMARTIT_ARROW_HPP
+
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "iterator.hpp"
+#include "simd.hpp"
+#include "vector.hpp"
+
+// Structures of the Apache Arrow C data interface, as defined in
+// https://arrow.apache.org/docs/format/CDataInterface.html
+#ifndef ARROW_C_DATA_INTERFACE
+#define ARROW_C_DATA_INTERFACE
+
+#define ARROW_FLAG_DICTIONARY_ORDERED 1
+#define ARROW_FLAG_NULLABLE 2
+#define ARROW_FLAG_MAP_KEYS_SORTED 4
+
+extern "C" {
+
+struct ArrowSchema {
+  // Array type description
+  const char *format;
+  const char *name;
+  const char *metadata;
+  int64_t flags;
+  int64_t n_children;
+  struct ArrowSchema **children;
+  struct ArrowSchema *dictionary;
+
+  // Release callback
+  void (*release)(struct ArrowSchema *);
+  // Opaque producer-specific data
+  void *private_data;
+};
+
+struct ArrowArray {
+  // Array data description
+  int64_t length;
+  int64_t null_count;
+  int64_t offset;
+  int64_t n_buffers;
+  int64_t n_children;
+  const void **buffers;
+  struct ArrowArray **children;
+  struct ArrowArray *dictionary;
+
+  // Release callback
+  void (*release)(struct ArrowArray *);
+  // Opaque producer-specific data
+  void *private_data;
+};
+}
+
+#endif // ARROW_C_DATA_INTERFACE
+
+namespace smit {
+
+  /**
+   * @brief Exchange of containers through the Apache Arrow C data interface
+   *
+   * Data objects map to struct arrays, with one child per field named after
+   * its position ("f0", "f1", ...). Nested data objects map to nested
+   * struct arrays. The values are never copied: exported arrays refer to
+   * the columns of the containers, and imported arrays are accessed through
+   * smit::arrow::array_view. Null values are not supported.
+   */
+  namespace arrow {
+
+    /// Format string of an arithmetic type
+    template <class Type> constexpr char const *format() {
+
+      static_assert(!std::is_same<Type, bool>::value,
+                    "Boolean fields can not be exported without a copy, "
+                    "since Arrow stores them as bits");
+
+      if constexpr (std::is_floating_point<Type>::value) {
+        static_assert(sizeof(Type) == 4 || sizeof(Type) == 8,
+                      "Unsupported floating point type");
+        return sizeof(Type) == 4 ? "f" : "g";
+      } else if constexpr (std::is_signed<Type>::value) {
+        constexpr char const *formats[] = {"c", "s", "", "i",
+                                           "",  "",  "", "l"};
+        return formats[sizeof(Type) - 1];
+      } else {
+        constexpr char const *formats[] = {"C", "S", "", "I",
+                                           "",  "",  "", "L"};
+        return formats[sizeof(Type) - 1];
+      }
+    }
+
+    /// Format string of struct arrays
+    constexpr char const struct_format[] = "+s";
+  } // namespace arrow
+
+  namespace core {
+
+    /// Data owned by the exported schemas
+    struct __arrow_schema_data {
+      /// Name of the field
+      std::string name;
+      /// Children
+      std::vector<ArrowSchema> children;
+      /// Pointers to the children
+      std::vector<ArrowSchema *> child_pointers;
+    };
+
+    /// Data owned by the exported arrays
+    struct __arrow_array_data {
+      /// Buffers (validity and values)
+      const void *buffers[2] = {nullptr, nullptr};
+      /// Children
+      std::vector<ArrowArray> children;
+      /// Pointers to the children
+      std::vector<ArrowArray *> child_pointers;
+      /// Object keeping the values alive
+      std::shared_ptr<void> owner;
+    };
+
+    /// Release an exported schema and its children
+    inline void _f_release_arrow_schema(ArrowSchema *schema) {
+      auto data = static_cast<__arrow_schema_data *>(schema->private_data);
+      for (auto &child : data->children)
+        if (child.release != nullptr)
+          child.release(&child);
+      delete data;
+      schema->release = nullptr;
+    }
+
+    /// Release an exported array and its children
+    inline void _f_release_arrow_array(ArrowArray *array) {
+      auto data = static_cast<__arrow_array_data *>(array->private_data);
+      for (auto &child : data->children)
+        if (child.release != nullptr)
+          child.release(&child);
+      delete data;
+      array->release = nullptr;
+    }
+
+    template <class... Types, size_t... I>
+    inline void _f_export_arrow_children(__arrow_schema_data &data,
+                                         utils::types_holder<Types...>,
+                                         std::index_sequence<I...>);
+
+    /// Fill the schema of a field with the given name
+    template <class Type>
+    inline void _f_export_arrow_schema(ArrowSchema *schema,
+                                       std::string name) {
+
+      auto data = new __arrow_schema_data{std::move(name), {}, {}};
+
+      *schema = ArrowSchema{};
+      schema->name = data->name.c_str();
+      schema->release = &_f_release_arrow_schema;
+      schema->private_data = data;
+
+      if constexpr (std::is_arithmetic<Type>::value)
+        schema->format = arrow::format<Type>();
+      else {
+        schema->format = arrow::struct_format;
+        _f_export_arrow_children(
+            *data, typename Type::types{},
+            std::make_index_sequence<Type::number_of_fields>{});
+        schema->n_children = data->children.size();
+        schema->children = data->child_pointers.data();
+      }
+    }
+
+    template <class... Types, size_t... I>
+    inline void _f_export_arrow_children(__arrow_schema_data &data,
+                                         utils::types_holder<Types...>,
+                                         std::index_sequence<I...>) {
+      data.children.resize(sizeof...(Types));
+      (_f_export_arrow_schema<Types>(&data.children[I],
+                                     "f" + std::to_string(I)),
+       ...);
+      for (auto &child : data.children)
+        data.child_pointers.push_back(&child);
+    }
+
+    template <class Type, class Columns, size_t... I>
+    inline void _f_export_arrow_fields(__arrow_array_data &data,
+                                       Columns const &columns, size_t size,
+                                       std::shared_ptr<void> const &owner,
+                                       std::index_sequence<I...>);
+
+    /// Fill the array of a field with the given column. Each array and its
+    /// children keep a reference to the owner of the values, so they remain
+    /// valid if the consumer moves the children out and releases the
+    /// parent.
+    template <class Type, class Column>
+    inline void _f_export_arrow_array(ArrowArray *array, Column const &column,
+                                      size_t size,
+                                      std::shared_ptr<void> const &owner) {
+
+      auto data = new __arrow_array_data;
+      data->owner = owner;
+
+      *array = ArrowArray{};
+      array->length = size;
+      array->buffers = data->buffers;
+      array->release = &_f_release_arrow_array;
+      array->private_data = data;
+
+      if constexpr (std::is_arithmetic<Type>::value) {
+        data->buffers[1] = size != 0 ? &column[0] : nullptr;
+        array->n_buffers = 2;
+      } else {
+        _f_export_arrow_fields<Type>(
+            *data, column, size, owner,
+            std::make_index_sequence<Type::number_of_fields>{});
+        array->n_buffers = 1;
+        array->n_children = data->children.size();
+        array->children = data->child_pointers.data();
+      }
+    }
+
+    template <class Type, class Columns, size_t... I>
+    inline void _f_export_arrow_fields(__arrow_array_data &data,
+                                       Columns const &columns, size_t size,
+                                       std::shared_ptr<void> const &owner,
+                                       std::index_sequence<I...>) {
+      data.children.resize(sizeof...(I));
+      (_f_export_arrow_array<
+           utils::tuple_element_for_t<I, typename Type::types>>(
+           &data.children[I], std::get<I>(columns), size, owner),
+       ...);
+      for (auto &child : data.children)
+        data.child_pointers.push_back(&child);
+    }
+  } // namespace core
+
+  namespace arrow {
+
+    /// Export the schema of a data object as a struct array
+    template <class Object> void export_schema(ArrowSchema *schema) {
+      core::_f_export_arrow_schema<Object>(schema, "");
+    }
+
+    /**
+     * @brief Export the elements of a smit::vector as a struct array
+     *
+     * The buffers refer to the columns of the vector, which must outlive
+     * the use of the array and not be reallocated in the meantime.
+     */
+    template <class Object, template <class> class Alloc>
+    void export_array(vector<Object, Alloc> const &container,
+                      ArrowArray *array) {
+      core::_f_export_arrow_array<Object>(array, core::_f_columns(container),
+                                          container.size(), nullptr);
+    }
+
+    /**
+     * @brief Export the elements of a smit::vector as a struct array, which
+     * takes ownership of the vector
+     *
+     * The vector is moved, so its columns are not copied, and it is
+     * destroyed when the consumer releases the array and all the children
+     * moved out of it.
+     */
+    template <class Object, template <class> class Alloc>
+    void export_array(vector<Object, Alloc> &&container, ArrowArray *array) {
+      auto owner =
+          std::make_shared<vector<Object, Alloc>>(std::move(container));
+      core::_f_export_arrow_array<Object>(array, core::_f_columns(*owner),
+                                          owner->size(), owner);
+    }
+  } // namespace arrow
+
+  namespace core {
+
+    /// Throw an exception reporting an invalid array
+    [[noreturn]] inline void _f_arrow_error(std::string const &what) {
+      throw std::invalid_argument("smit::arrow::array_view: " + what);
+    }
+
+    template <class Type, class Columns, size_t... I>
+    inline void _f_import_arrow_fields(Columns &columns,
+                                       ArrowArray const *array,
+                                       ArrowSchema const *schema,
+                                       size_t offset, size_t size,
+                                       std::index_sequence<I...>);
+
+    /**
+     * @brief Point a column to the buffer of an array, checking that it
+     * matches the field
+     *
+     * The offset accumulates those of the parents, and the array must hold
+     * at least offset + size elements.
+     */
+    template <class Type, class Column>
+    inline void _f_import_arrow_array(Column &column, ArrowArray const *array,
+                                      ArrowSchema const *schema,
+                                      size_t offset, size_t size) {
+
+      if (array == nullptr || array->release == nullptr)
+        _f_arrow_error("released or missing array");
+      // a null count of -1 means that it was not computed, which is only
+      // accepted if there is no validity bitmap
+      bool const bitmap = array->n_buffers > 0 && array->buffers != nullptr &&
+                          array->buffers[0] != nullptr;
+      if (array->null_count > 0 || (bitmap && array->null_count != 0))
+        _f_arrow_error("null values are not supported");
+
+      offset += array->offset;
+
+      if (size_t(array->length) + array->offset < offset + size)
+        _f_arrow_error("array too short");
+
+      if constexpr (std::is_arithmetic<Type>::value) {
+        if (schema != nullptr &&
+            std::string{schema->format} != arrow::format<Type>())
+          _f_arrow_error("wrong format \"" + std::string{schema->format} +
+                         "\"");
+        if (array->n_buffers != 2)
+          _f_arrow_error("wrong number of buffers");
+        column =
+            const_cast<Type *>(static_cast<Type const *>(array->buffers[1])) +
+            offset;
+      } else {
+        if (schema != nullptr &&
+            std::string{schema->format} != arrow::struct_format)
+          _f_arrow_error("wrong format \"" + std::string{schema->format} +
+                         "\"");
+        if (array->n_children != Type::number_of_fields ||
+            (schema != nullptr &&
+             schema->n_children != Type::number_of_fields))
+          _f_arrow_error("wrong number of children");
+        _f_import_arrow_fields<Type>(
+            column, array, schema, offset, size,
+            std::make_index_sequence<Type::number_of_fields>{});
+      }
+    }
+
+    template <class Type, class Columns, size_t... I>
+    inline void _f_import_arrow_fields(Columns &columns,
+                                       ArrowArray const *array,
+                                       ArrowSchema const *schema,
+                                       size_t offset, size_t size,
+                                       std::index_sequence<I...>) {
+      (_f_import_arrow_array<
+           utils::tuple_element_for_t<I, typename Type::types>>(
+           std::get<I>(columns), array->children[I],
+           schema != nullptr ? schema->children[I] : nullptr, offset, size),
+       ...);
+    }
+  } // namespace core
+
+  namespace arrow {
+
+    /**
+     * @brief Read-only view of an Arrow struct array as a container of data
+     * objects
+     *
+     * The columns refer to the buffers of the array, which must outlive the
+     * view and are not released by it. The structure of the array (and of
+     * the schema, if given) is checked on construction, reporting
+     * mismatches with std::invalid_argument. Elements are accessed through
+     * the same constant iterators and container types as smit::vector.
+     */
+    template <class Object>
+    class array_view : public core::__vector_columns<Object> {
+
+    public:
+      /// Base class
+      using base_class = core::__vector_columns<Object>;
+      /// Type of the elements
+      using value_type = Object;
+      /// Iterator (constant)
+      using iterator = core::__const_iterator<base_class, Object>;
+      /// Constant iterator
+      using const_iterator = iterator;
+      /// Type of the container returned on access (constant)
+      using reference = typename iterator::reference;
+      /// Type of the container returned on access (constant)
+      using const_reference = reference;
+      /// Type of the distance between iterators
+      using difference_type = typename iterator::difference_type;
+
+      /// Build the view from an array and, optionally, its schema
+      explicit array_view(ArrowArray const *array,
+                          ArrowSchema const *schema = nullptr)
+          : base_class{} {
+        if (array == nullptr)
+          core::_f_arrow_error("missing array");
+        m_size = array->length;
+        core::_f_import_arrow_array<Object>(
+            static_cast<base_class &>(*this), array, schema, 0, m_size);
+      }
+
+      inline const_reference operator[](size_t i) const {
+        return *(this->begin() + i);
+      }
+
+      /// Get the number of elements
+      inline size_t size() const { return m_size; }
+
+      /// Test whether the view is empty
+      inline bool empty() const { return this->size() == 0; }
+
+      /// Call a function on batches of W consecutive elements
+      template <size_t W = simd::default_width<Object>, class Function>
+      void for_each_batch(Function &&f) const {
+        core::_f_for_each_batch<W, Object>(
+            static_cast<base_class const &>(*this), m_size, f);
+      }
+
+      /// Begining of the view
+      const_iterator begin() const { return {*this, 0}; }
+
+      /// Begining of the view
+      const_iterator cbegin() const { return {*this, 0}; }
+
+      /// End of the view
+      const_iterator end() const {
+        return {*this, difference_type(m_size)};
+      }
+
+      /// End of the view
+      const_iterator cend() const {
+        return {*this, difference_type(m_size)};
+      }
+
+    private:
+      /// Number of elements
+      size_t m_size = 0;
+    };
+  } // namespace arrow
+} // namespace smit
+
+#endif // SMARTIT_ARROW_HPP
@@ -0,0 +1,47 @@
+#ifndef SMARTIT_CONTAINER_HPP
+#define SMARTIT_CONTAINER_HPP
+
+#include <memory>
+
+#include "layout.hpp"
+#include "tiled_vector.hpp"
+#include "vector.hpp"
+
+namespace smit {
+
+  namespace core {
+
+    /// Dynamic container storing the elements with the given layout
+    template <class Object, class Layout, template <class> class Alloc>
+    struct layout_container {}; // primary template
+
+    template <class Object, template <class> class Alloc>
+    struct layout_container<Object, layout::soa, Alloc> {
+      using type = vector<Object, Alloc>;
+    };
+
+    template <class Object, size_t W, template <class> class Alloc>
+    struct layout_container<Object, layout::aosoa<W>, Alloc> {
+      using type = tiled_vector<Object, W, Alloc>;
+    };
+  } // namespace core
+
+  /**
+   * @brief Dynamic container of data objects with a selectable layout
+   *
+   * Resolves to smit::vector for smit::layout::soa and to smit::tiled_vector
+   * for smit::layout::aosoa (and smit::layout::aos). Their interfaces,
+   * iterators and container types are the same, so switching the layout of
+   * a loop only requires changing this type.
+   *
+   * @code
+   * smit::container<smit::point_3d<float>, smit::layout::aos> v(n);
+   * @endcode
+   */
+  template <class Object, class Layout = layout::soa,
+            template <class> class Alloc = std::allocator>
+  using container =
+      typename core::layout_container<Object, Layout, Alloc>::type;
+} // namespace smit
+
+#endif // SMARTIT_CONTAINER_HPP
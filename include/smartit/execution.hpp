@@ -0,0 +1,114 @@
+#ifndef SMARTIT_EXECUTION_HPP
+#define SMARTIT_EXECUTION_HPP
+
+#include <algorithm>
+#include <type_traits>
+
+#include "thread_pool.hpp"
+
+namespace smit {
+
+  /**
+   * @brief Execution policies for the algorithms
+   *
+   * They mirror those of the standard library. The parallel policies split
+   * the ranges in contiguous chunks, processed by the threads of the
+   * default smit::thread_pool. Exceptions thrown by the functions called in
+   * parallel are propagated to the calling thread.
+   */
+  namespace execution {
+
+    /// Process the elements in order in the calling thread
+    struct sequenced_policy {};
+
+    /// Split the elements among several threads
+    struct parallel_policy {};
+
+    /// Split the elements among several threads, allowing to vectorize the
+    /// processing of each chunk
+    struct parallel_unsequenced_policy {};
+
+    /// Sequential execution policy
+    constexpr sequenced_policy seq{};
+    /// Parallel execution policy
+    constexpr parallel_policy par{};
+    /// Parallel and unsequenced execution policy
+    constexpr parallel_unsequenced_policy par_unseq{};
+
+    /// Check whether a type is an execution policy
+    template <class T> struct is_execution_policy : std::false_type {};
+
+    template <>
+    struct is_execution_policy<sequenced_policy> : std::true_type {};
+
+    template <>
+    struct is_execution_policy<parallel_policy> : std::true_type {};
+
+    template <>
+    struct is_execution_policy<parallel_unsequenced_policy>
+        : std::true_type {};
+
+    /// Value of smit::execution::is_execution_policy
+    template <class T>
+    constexpr bool is_execution_policy_v =
+        is_execution_policy<std::decay_t<T>>::value;
+  } // namespace execution
+
+  namespace core {
+
+    /// Number of elements per chunk for the parallel policies
+    constexpr size_t parallel_grain = 1u << 14;
+
+    /// Number of chunks in which a range is split for the given policy. It
+    /// only depends on the size, so reductions are deterministic.
+    template <class Policy>
+    inline size_t _f_number_of_chunks(Policy const &, size_t size) {
+      if constexpr (std::is_same<std::decay_t<Policy>,
+                                 execution::sequenced_policy>::value)
+        return size != 0;
+      else
+        return (size + parallel_grain - 1) / parallel_grain;
+    }
+
+    /// Number of chunks in which a range is split for the given policy
+    /// when each chunk needs its own copy of a state that can be as large
+    /// as the result, so there is at most one per thread of the default
+    /// pool (including the calling thread)
+    template <class Policy>
+    inline size_t _f_number_of_partitions(Policy const &policy, size_t size) {
+      size_t const chunks = _f_number_of_chunks(policy, size);
+      if (chunks <= 1)
+        return chunks;
+      return std::min(chunks, thread_pool::default_pool().size() + 1);
+    }
+
+    /**
+     * @brief Call a function on the chunks of the range [0, size)
+     *
+     * The function is called as f(chunk, begin, end). Several chunks are
+     * processed in parallel by the default thread pool.
+     *
+     * @see smit::thread_pool
+     */
+    template <class Function>
+    inline void _f_parallel_chunks(size_t size, size_t chunks, Function &&f) {
+      if (chunks == 1)
+        f(size_t{0}, size_t{0}, size);
+      else
+        thread_pool::default_pool().parallel_chunks(size, chunks, f);
+    }
+
+    /**
+     * @brief Call f(i) for each i in [0, n) as separate tasks of the
+     * default thread pool
+     *
+     * @see smit::thread_pool::parallel_tasks
+     */
+    template <class Function>
+    inline void _f_parallel_tasks(size_t n, Function &&f) {
+      thread_pool::default_pool().parallel_tasks(n, f);
+    }
+  } // namespace core
+} // namespace smit
+
+#endif // SMARTIT_EXECUTION_HPP
@@ -0,0 +1,416 @@
+#ifndef SMARTIT_EXPRESSION_HPP
+#define SMARTIT_EXPRESSION_HPP
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "simd.hpp"
+#include "traits.hpp"
+#include "value.hpp"
+
+namespace smit {
+
+  namespace core {
+
+    /// Check whether a type is a container of data objects
+    template <class T, class Enable = void>
+    struct is_container : std::false_type {};
+
+    template <class T>
+    struct is_container<T, std::void_t<typename T::base_class,
+                                       typename T::value_type,
+                                       typename T::iterator>>
+        : std::true_type {};
+
+    /// Access a field of an object, or the object itself if it is a scalar
+    template <size_t I, class T> inline auto const &_f_field(T const &obj) {
+      if constexpr (has_fields<T>::value)
+        return std::get<I>(obj);
+      else
+        return obj;
+    }
+
+    template <class Operation, class A, class B, size_t... I>
+    inline auto _f_fieldwise_impl(Operation const &op, A const &a,
+                                  B const &b, std::index_sequence<I...>);
+
+    /**
+     * @brief Apply a binary operation field by field
+     *
+     * If one of the operands is a scalar (or a pack), it is combined with
+     * all the fields of the other. The result is a data object with the
+     * prototype of the operands.
+     */
+    template <class Operation, class A, class B>
+    inline auto _f_fieldwise(Operation const &op, A const &a, B const &b) {
+      if constexpr (has_fields<A>::value)
+        return _f_fieldwise_impl(
+            op, a, b, std::make_index_sequence<A::number_of_fields>{});
+      else if constexpr (has_fields<B>::value)
+        return _f_fieldwise_impl(
+            op, a, b, std::make_index_sequence<B::number_of_fields>{});
+      else
+        return op(a, b);
+    }
+
+    template <class Operation, class A, class B, size_t... I>
+    inline auto _f_fieldwise_impl(Operation const &op, A const &a,
+                                  B const &b, std::index_sequence<I...>) {
+
+      using object = std::conditional_t<has_fields<A>::value, A, B>;
+
+      return data_object<
+          traits::extract_prototype<object>::template type,
+          decltype(_f_fieldwise(op, _f_field<I>(a), _f_field<I>(b)))...>{
+          _f_fieldwise(op, _f_field<I>(a), _f_field<I>(b))...};
+    }
+
+    /// Apply an unary operation field by field
+    template <class Operation, class A, size_t... I>
+    inline auto _f_fieldwise_unary_impl(Operation const &op, A const &a,
+                                        std::index_sequence<I...>);
+
+    template <class Operation, class A>
+    inline auto _f_fieldwise(Operation const &op, A const &a) {
+      if constexpr (has_fields<A>::value)
+        return _f_fieldwise_unary_impl(
+            op, a, std::make_index_sequence<A::number_of_fields>{});
+      else
+        return op(a);
+    }
+
+    template <class Operation, class A, size_t... I>
+    inline auto _f_fieldwise_unary_impl(Operation const &op, A const &a,
+                                        std::index_sequence<I...>) {
+      return data_object<traits::extract_prototype<A>::template type,
+                         decltype(_f_fieldwise(op, std::get<I>(a)))...>{
+          _f_fieldwise(op, std::get<I>(a))...};
+    }
+
+    /// Addition
+    struct __plus {
+      template <class A, class B>
+      auto operator()(A const &a, B const &b) const {
+        return a + b;
+      }
+    };
+
+    /// Subtraction
+    struct __minus {
+      template <class A, class B>
+      auto operator()(A const &a, B const &b) const {
+        return a - b;
+      }
+    };
+
+    /// Multiplication
+    struct __multiplies {
+      template <class A, class B>
+      auto operator()(A const &a, B const &b) const {
+        return a * b;
+      }
+    };
+
+    /// Division
+    struct __divides {
+      template <class A, class B>
+      auto operator()(A const &a, B const &b) const {
+        return a / b;
+      }
+    };
+
+    /// Negation
+    struct __negate {
+      template <class A> auto operator()(A const &a) const { return -a; }
+    };
+
+    /// Base class of the expression nodes
+    struct __expression {};
+
+    /// Check whether a type is an expression node
+    template <class T>
+    using is_expression = std::is_base_of<__expression, T>;
+
+    /**
+     * @brief Expression referring to the elements of a container
+     *
+     * The container is stored by reference, so it must outlive the
+     * expression.
+     */
+    template <class Container> class __terminal_expression : __expression {
+
+    public:
+      /// Type of the elements
+      using value_type = typename Container::value_type;
+      /// Maximum number of lanes of the batches
+      static constexpr size_t max_width = max_batch_width<Container>::value;
+
+      /// Build the expression from the container
+      __terminal_expression(Container const &container)
+          : m_container{container} {}
+
+      /// Number of elements
+      size_t size() const { return m_container.size(); }
+
+      /// Load the elements in [index, index + n), where the position is a
+      /// multiple of W
+      template <size_t W>
+      simd::batch<value_type, W> batch(size_t index, size_t n) const {
+        simd::batch<value_type, W> b;
+        _f_load_batch<column_alignment<Container>::value>(
+            b, _f_columns(m_container), index, n);
+        return b;
+      }
+
+    protected:
+      /// Container
+      Container const &m_container;
+    };
+
+    /**
+     * @brief Expression holding a scalar value
+     *
+     * The value is broadcasted to all the elements. Scalars have no size,
+     * so the size is determined by the rest of operands.
+     */
+    template <class T> class __scalar_expression : __expression {
+
+    public:
+      /// Type of the value
+      using value_type = T;
+      /// Maximum number of lanes of the batches
+      static constexpr size_t max_width = std::numeric_limits<size_t>::max();
+
+      /// Build the expression from the value
+      __scalar_expression(T value) : m_value{value} {}
+
+      /// Number of elements
+      size_t size() const { return 0; }
+
+      /// Value, broadcasted when combined with packs
+      template <size_t W> T batch(size_t, size_t) const { return m_value; }
+
+    protected:
+      /// Value
+      T m_value;
+    };
+
+    /// Check whether a type is an expression holding a scalar value
+    template <class T> struct is_scalar_expression : std::false_type {};
+
+    template <class T>
+    struct is_scalar_expression<__scalar_expression<T>> : std::true_type {};
+
+    /**
+     * @brief Number of elements of the operands of an expression, ignoring
+     * the scalars
+     *
+     * @throws std::length_error if the operands have different sizes
+     */
+    template <class... Operands>
+    inline size_t _f_common_size(Operands const &... operands) {
+
+      size_t size = 0;
+      bool sized = false;
+
+      auto check = [&size, &sized](auto const &op) {
+        if constexpr (!is_scalar_expression<
+                          std::decay_t<decltype(op)>>::value) {
+          if (!sized) {
+            size = op.size();
+            sized = true;
+          } else if (op.size() != size)
+            throw std::length_error(
+                "smit: the operands of an expression have different sizes");
+        }
+      };
+
+      (check(operands), ...);
+
+      return size;
+    }
+
+    /**
+     * @brief Expression applying a function to the elements of its operands
+     *
+     * The function is called on batches, so it must be generic with
+     * respect to the types of the fields. All the operands, except the
+     * scalars, must have the same size.
+     */
+    template <class Function, class... Operands>
+    class __function_expression : __expression {
+
+    public:
+      /// Type of the elements
+      using value_type = decltype(std::declval<Function const &>()(
+          std::declval<typename Operands::value_type const &>()...));
+      /// Maximum number of lanes of the batches
+      static constexpr size_t max_width = std::min({Operands::max_width...});
+
+      /// Build the expression from the function and the operands
+      __function_expression(Function const &function,
+                            Operands const &... operands)
+          : m_function{function}, m_operands{operands...} {
+        _f_common_size(operands...);
+      }
+
+      /// Number of elements
+      size_t size() const {
+        return std::apply(
+            [](auto const &... op) { return _f_common_size(op...); },
+            m_operands);
+      }
+
+      /// Evaluate the elements in [index, index + n)
+      template <size_t W> auto batch(size_t index, size_t n) const {
+        return std::apply(
+            [&](auto const &... op) {
+              return m_function(op.template batch<W>(index, n)...);
+            },
+            m_operands);
+      }
+
+    protected:
+      /// Function
+      Function m_function;
+      /// Operands
+      std::tuple<Operands...> m_operands;
+    };
+
+    /// Function applying an operation field by field
+    template <class Operation> struct __fieldwise {
+      template <class... Args> auto operator()(Args const &... args) const {
+        return _f_fieldwise(Operation{}, args...);
+      }
+    };
+
+    /// Whether the type can be used as an operand of an expression
+    template <class T>
+    using is_operand =
+        std::integral_constant<bool, is_expression<T>::value ||
+                                         is_container<T>::value ||
+                                         std::is_arithmetic<T>::value>;
+
+    /// Whether any of the types is an expression or a container, and all of
+    /// them can be used as operands
+    template <class... T>
+    using is_lazy_operation = std::integral_constant<
+        bool, ((is_expression<T>::value || is_container<T>::value) || ...) &&
+                  (is_operand<T>::value && ...)>;
+
+    /// Convert a value to an expression node
+    template <class T> inline auto _f_operand(T const &value) {
+      if constexpr (is_expression<T>::value)
+        return value;
+      else if constexpr (is_container<T>::value)
+        return __terminal_expression<T>{value};
+      else
+        return __scalar_expression<T>{value};
+    }
+
+    /// Type of the expression node for the given value
+    template <class T>
+    using operand_t = decltype(_f_operand(std::declval<T const &>()));
+
+    /// Build an expression node applying a function to some operands
+    template <class Function, class... Operands>
+    inline auto _f_make_expression(Function const &function,
+                                   Operands const &... operands) {
+      return __function_expression<Function, operand_t<Operands>...>{
+          function, _f_operand(operands)...};
+    }
+
+    /**
+     * @brief Evaluate an expression, storing the result in the columns of a
+     * container
+     *
+     * The elements are evaluated in batches of the native SIMD width, in a
+     * single pass over the operands. Columns aligned to A bytes are written
+     * with aligned stores.
+     */
+    template <size_t A = 1, class Expression, class Columns>
+    inline void _f_evaluate(Expression const &expression, Columns &columns,
+                            size_t size) {
+
+      constexpr auto W =
+          std::min(batch_width<typename Expression::value_type, Columns>,
+                   Expression::max_width);
+
+      size_t i = 0;
+
+      for (; i + W <= size; i += W)
+        _f_store_batch<A>(expression.template batch<W>(i, W), columns, i, W);
+
+      if (i != size)
+        _f_store_batch<A>(expression.template batch<W>(i, size - i), columns,
+                          i, size - i);
+    }
+  } // namespace core
+
+  /**
+   * @brief Build a lazy expression applying a function to some operands
+   *
+   * Operands can be containers, other expressions or scalars. The function
+   * is called on batches of elements (see smit::simd::batch), so it can be
+   * any generic function defined for the prototypes. The expression is
+   * evaluated when assigned to a container.
+   *
+   * \code{.cpp}
+     smit::vector<smit::point_3d<float>> a(n), b(n), out;
+     out = smit::make_expression(
+         [](auto const &u, auto const &v) { return smit::cross(u, v); }, a,
+         b);
+   * \endcode
+   */
+  template <class Function, class... Operands,
+            class = std::enable_if_t<
+                core::is_lazy_operation<Operands...>::value>>
+  inline auto make_expression(Function const &function,
+                              Operands const &... operands) {
+    return core::_f_make_expression(function, operands...);
+  }
+
+  /// Lazy addition, field by field
+  template <class L, class R,
+            class = std::enable_if_t<core::is_lazy_operation<L, R>::value>>
+  inline auto operator+(L const &l, R const &r) {
+    return core::_f_make_expression(core::__fieldwise<core::__plus>{}, l, r);
+  }
+
+  /// Lazy subtraction, field by field
+  template <class L, class R,
+            class = std::enable_if_t<core::is_lazy_operation<L, R>::value>>
+  inline auto operator-(L const &l, R const &r) {
+    return core::_f_make_expression(core::__fieldwise<core::__minus>{}, l,
+                                    r);
+  }
+
+  /// Lazy multiplication, field by field
+  template <class L, class R,
+            class = std::enable_if_t<core::is_lazy_operation<L, R>::value>>
+  inline auto operator*(L const &l, R const &r) {
+    return core::_f_make_expression(core::__fieldwise<core::__multiplies>{},
+                                    l, r);
+  }
+
+  /// Lazy division, field by field
+  template <class L, class R,
+            class = std::enable_if_t<core::is_lazy_operation<L, R>::value>>
+  inline auto operator/(L const &l, R const &r) {
+    return core::_f_make_expression(core::__fieldwise<core::__divides>{}, l,
+                                    r);
+  }
+
+  /// Lazy negation, field by field
+  template <class A,
+            class = std::enable_if_t<core::is_lazy_operation<A>::value>>
+  inline auto operator-(A const &a) {
+    return core::_f_make_expression(core::__fieldwise<core::__negate>{}, a);
+  }
+} // namespace smit
+
+#endif // SMARTIT_EXPRESSION_HPP
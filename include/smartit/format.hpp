@@ -0,0 +1,75 @@
+#ifndef SMARTIT_FORMAT_HPP
+#define SMARTIT_FORMAT_HPP
+
+#include <array>
+#include <cstdint>
+#include <type_traits>
+
+#include "value.hpp"
+
+namespace smit {
+
+  namespace core {
+
+    /// Kind of arithmetic type stored in a column of a file
+    enum class type_kind : std::uint32_t {
+      signed_integer = 0,
+      unsigned_integer = 1,
+      floating_point = 2
+    };
+
+    /**
+     * @brief Description of the type of a column in a file
+     *
+     * Types are described by their kind and their size in bytes, so files
+     * written on platforms with the same byte order can be read back
+     * regardless of the names of the types.
+     */
+    struct __type_code {
+      /// Kind of type
+      type_kind kind;
+      /// Size of the type (in bytes)
+      std::uint32_t size;
+
+      /// Comparison operator (equality)
+      constexpr bool operator==(__type_code const &other) const {
+        return kind == other.kind && size == other.size;
+      }
+
+      /// Comparison operator (inequality)
+      constexpr bool operator!=(__type_code const &other) const {
+        return !(*this == other);
+      }
+    };
+
+    /// Code of an arithmetic type
+    template <class Type> constexpr __type_code _f_type_code() {
+
+      static_assert(std::is_arithmetic<Type>::value,
+                    "Only arithmetic types can be stored in files");
+
+      if constexpr (std::is_floating_point<Type>::value)
+        return {type_kind::floating_point, sizeof(Type)};
+      else if constexpr (std::is_signed<Type>::value)
+        return {type_kind::signed_integer, sizeof(Type)};
+      else
+        return {type_kind::unsigned_integer, sizeof(Type)};
+    }
+
+    template <class... Types>
+    constexpr std::array<__type_code, sizeof...(Types)>
+        _f_type_codes(utils::types_holder<Types...>) {
+      return {_f_type_code<Types>()...};
+    }
+
+    /// Codes of the arithmetic fields of an object, in the order of the
+    /// columns (nested data objects are flattened depth-first)
+    template <class Object>
+    constexpr auto column_type_codes = _f_type_codes(leaf_types_t<Object>{});
+
+    /// Value used to check that a file was written with the same byte order
+    constexpr std::uint32_t byte_order_mark = 0x01020304;
+  } // namespace core
+} // namespace smit
+
+#endif // SMARTIT_FORMAT_HPP
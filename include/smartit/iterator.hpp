@@ -1,8 +1,10 @@
 #ifndef SMARTIT_ITERATOR_HPP
 #define SMARTIT_ITERATOR_HPP
 
+#include <cstddef>
 #include <iterator>
-#include <tuple>
+#include <type_traits>
+#include <utility>
 
 #include "traits.hpp"
 #include "value.hpp"
@@ -11,429 +13,199 @@ namespace smit {
 
   namespace core {
 
+    /**
+     * @brief Object returned by the access operator of the iterators
+     *
+     * Holds the container type built on dereference, so the access operator
+     * can be chained.
+     */
+    template <class Reference> class __arrow_proxy {
+
+    public:
+      /// Build the proxy from the reference
+      __arrow_proxy(Reference &&reference)
+          : m_reference{std::move(reference)} {}
+
+      /// Access operator
+      Reference *operator->() { return &m_reference; }
+
+    protected:
+      /// Reference to the element
+      Reference m_reference;
+    };
+
     /**
      * @brief Iterator type
+     *
+     * The iterator stores a pointer to the columns of the container and the
+     * position of the element. The container type giving access to the
+     * fields is only built on dereference, so the size of the iterator and
+     * the cost of moving it do not depend on the number of fields. If the
+     * columns are constant, the iterator gives read-only access to the
+     * fields.
+     *
+     * The container type behaves as a reference: assigning to it, or
+     * swapping two of them, modifies the values of the fields, and it can
+     * be converted to the value type, so the algorithms of the standard
+     * library that move elements can be used on the containers.
      */
-    template <template <class> class Proxy, class Object>
-    class __iterator
-        : public traits::iterator_base<Proxy, typename Object::types> {
+    template <class Columns, class Object> class __iterator {
 
     public:
-      /// Base class
-      using base_class = traits::iterator_base<Proxy, typename Object::types>;
-      using iterator_types = decltype(
-          traits::_f_iterator_proxies<Proxy>(typename Object::types{}));
       using types = typename Object::types;
 
+      /// Whether the iterator gives read-only access to the fields
+      static constexpr bool is_const = std::is_const<Columns>::value;
+
       /// Type of the container
-      using value_type = core::__container_type<
-          traits::extract_prototype<Object>::template type, iterator_types>;
-      using difference_type = ptrdiff_t;
-      using pointer_type = value_type *;
-      using reference_type = value_type &;
+      using reference = core::__container_type<
+          traits::extract_prototype<Object>::template type, is_const, types>;
+      using value_type = Object;
+      using difference_type = std::ptrdiff_t;
+      using pointer = __arrow_proxy<reference>;
       using iterator_category = std::random_access_iterator_tag;
       /// Number of fields
       static const auto number_of_fields = Object::number_of_fields;
 
-      explicit __iterator() : base_class{}, m_container{*this} {}
-
-      // Similar constructors to those of std::tuple
-      template <class... Iterators>
-      explicit __iterator(Iterators const &... args)
-          : base_class{args...}, m_container{*this} {}
-
-      /// Constructors for cases with no arguments (default) and with
-      /// iterators
-      template <class... UIterators>
-      __iterator(UIterators &&... args)
-          : base_class{args...}, m_container{*this} {}
+      /// Default constructor
+      __iterator() : m_columns{nullptr}, m_index{0} {}
 
-      __iterator(const __iterator &other)
-          : base_class(other), m_container{*this} {}
-      __iterator(__iterator &&other) : base_class(other), m_container{*this} {}
+      /// Build the iterator from the columns and the position of the element
+      __iterator(Columns &columns, difference_type index)
+          : m_columns{&columns}, m_index{index} {}
 
-      __iterator &operator=(const __iterator &other) {
-        base_class::operator=(other);
-        return *this;
-      }
-
-      __iterator &operator=(__iterator &&other) {
-        base_class::operator=(other);
-        return *this;
-      }
+      /// Build a constant iterator from a non-constant iterator
+      template <class C,
+                class = typename std::enable_if<
+                    std::is_same<C const, Columns>::value &&
+                    !std::is_same<C, Columns>::value>::type>
+      __iterator(__iterator<C, Object> const &other)
+          : m_columns{other.m_columns}, m_index{other.m_index} {}
 
       /// Access operator
-      pointer_type operator->() { return &m_container; }
-
-      /// Access operator (constant)
-      pointer_type operator->() const { return &m_container; }
+      pointer operator->() const { return **this; }
 
       /// Dereference operator
-      reference_type operator*() { return m_container; }
+      reference operator*() const { return reference(*m_columns, m_index); }
 
-      /// Dereference operator (constant)
-      reference_type const operator*() const { return m_container; }
+      /// Access to the element at the given distance
+      reference operator[](difference_type n) const {
+        return reference(*m_columns, m_index + n);
+      }
 
       /// Increment operator
       __iterator &operator++() {
-
-        this->next_impl(std::make_index_sequence<number_of_fields>{});
-
+        ++m_index;
         return *this;
       }
 
       /// Increment operator (copy)
       __iterator operator++(int) {
-
         __iterator copy{*this};
-
-        this->next_impl(std::make_index_sequence<number_of_fields>{});
-
+        ++m_index;
         return copy;
       }
 
       /// Decrement operator
       __iterator &operator--() {
-
-        this->prev_impl(std::make_index_sequence<number_of_fields>{});
-
+        --m_index;
         return *this;
       }
 
       /// Decrement operator (copy)
       __iterator operator--(int) {
-
         __iterator copy{*this};
-
-        this->prev_impl(std::make_index_sequence<number_of_fields>{});
-
+        --m_index;
         return copy;
       }
 
       /// Add operator
-      __iterator operator+(size_t n) const {
-        __iterator copy{*this};
-        return copy += n;
+      __iterator operator+(difference_type n) const {
+        return __iterator{*m_columns, m_index + n};
       }
 
       /// Add operator (inplace)
-      __iterator &operator+=(size_t n) {
-        return this->add_impl(n, std::make_index_sequence<number_of_fields>{});
+      __iterator &operator+=(difference_type n) {
+        m_index += n;
+        return *this;
       }
 
       /// Subtract operator
-      __iterator operator-(size_t n) const {
-        __iterator copy{*this};
-        return copy += n;
+      __iterator operator-(difference_type n) const {
+        return __iterator{*m_columns, m_index - n};
       }
 
-      /// Add operator (inplace)
-      __iterator &operator-=(size_t n) {
-        return this->sub_impl(n, std::make_index_sequence<number_of_fields>{});
+      /// Subtract operator (inplace)
+      __iterator &operator-=(difference_type n) {
+        m_index -= n;
+        return *this;
       }
 
       /// Distance to another iterator
-      difference_type operator-(__iterator const &other) const {
-        if constexpr (number_of_fields == 0)
-          return 0;
-        else
-          return std::get<0>(*this) - std::get<0>(other);
+      template <class C>
+      difference_type operator-(__iterator<C, Object> const &other) const {
+        return m_index - other.m_index;
       }
 
       /// Comparison operator (equality)
-      template <class Iterator>
-      typename std::enable_if<(number_of_fields == Iterator::number_of_fields),
-                              bool>::type
-      operator==(Iterator const &other) const {
-
-        if constexpr (number_of_fields == 0)
-          return true;
-        else
-          return std::get<0>(*this) == std::get<0>(other);
+      template <class C>
+      bool operator==(__iterator<C, Object> const &other) const {
+        return m_index == other.m_index;
       }
 
       /// Comparison operator (inequality)
-      template <class Iterator>
-      typename std::enable_if<(number_of_fields == Iterator::number_of_fields),
-                              bool>::type
-      operator!=(Iterator const &other) const {
-
-        if constexpr (number_of_fields == 0)
-          return true;
-        else
-          return std::get<0>(*this) != std::get<0>(other);
+      template <class C>
+      bool operator!=(__iterator<C, Object> const &other) const {
+        return m_index != other.m_index;
       }
 
-      template <class Iterator> bool operator<(Iterator const &other) {
-        if constexpr (number_of_fields == 0)
-          return true;
-        else
-          return std::get<0>(*this) < std::get<0>(other);
+      template <class C>
+      bool operator<(__iterator<C, Object> const &other) const {
+        return m_index < other.m_index;
       }
 
-      template <class Iterator> bool operator<=(Iterator const &other) {
-        if constexpr (number_of_fields == 0)
-          return true;
-        else
-          return std::get<0>(*this) <= std::get<0>(other);
+      template <class C>
+      bool operator<=(__iterator<C, Object> const &other) const {
+        return m_index <= other.m_index;
       }
 
-      template <class Iterator> bool operator>(Iterator const &other) {
-        if constexpr (number_of_fields == 0)
-          return true;
-        else
-          return std::get<0>(*this) > std::get<0>(other);
+      template <class C>
+      bool operator>(__iterator<C, Object> const &other) const {
+        return m_index > other.m_index;
       }
 
-      template <class Iterator> bool operator>=(Iterator const &other) {
-        if constexpr (number_of_fields == 0)
-          return true;
-        else
-          return std::get<0>(*this) >= std::get<0>(other);
+      template <class C>
+      bool operator>=(__iterator<C, Object> const &other) const {
+        return m_index >= other.m_index;
       }
 
-    protected:
-      /// Container instance
-      value_type m_container;
-
-    private:
-      /// Implementation of the add function
-      template <size_t... I>
-      inline __iterator &add_impl(size_t n, std::index_sequence<I...>) {
-        (std::next(std::get<I>(*this), n), ...);
-        return *this;
+      /// Add operator (with the distance first)
+      friend __iterator operator+(difference_type n, __iterator const &it) {
+        return it + n;
       }
 
-      /// Implementation of the subtract function
-      template <size_t... I>
-      inline __iterator &sub_impl(size_t n, std::index_sequence<I...>) {
-        (std::prev(std::get<I>(*this), n), ...);
-        return *this;
-      }
+      /// Move the values of the fields of the element out of the container
+      friend value_type iter_move(__iterator const &it) { return *it; }
 
-      /// Implementation of the function to access the next element
-      template <size_t... I>
-      constexpr void next_impl(std::index_sequence<I...>) {
-        (++std::get<I>(*this), ...);
+      /// Swap the values of the fields of the elements of two iterators
+      friend void iter_swap(__iterator const &a, __iterator const &b) {
+        swap(*a, *b);
       }
 
-      /// Implementation of the function to access the previous element
-      template <size_t... I>
-      constexpr void prev_impl(std::index_sequence<I...>) {
-        (--std::get<I>(*this), ...);
-      }
+    protected:
+      template <class, class> friend class __iterator;
+
+      /// Columns of the container
+      Columns *m_columns;
+      /// Position of the element
+      difference_type m_index;
     };
 
     /**
-     * @brief Constat iterator type
+     * @brief Constant iterator type
      */
-    template <template <class> class Proxy, class Object>
-    class __const_iterator
-        : public traits::const_iterator_base<Proxy, typename Object::types> {
-
-    public:
-      /// Base class
-      using base_class =
-          traits::const_iterator_base<Proxy, typename Object::types>;
-      using const_iterator_types = decltype(
-          traits::_f_const_iterator_proxies<Proxy>(typename Object::types{}));
-      using types = typename Object::types;
-      /// Type of the container
-      using value_type = core::__container_type<
-          traits::extract_prototype<Object>::template type,
-          const_iterator_types>;
-      using difference_type = ptrdiff_t;
-      using pointer_type = value_type const *;
-      using reference_type = value_type const &;
-      using iterator_category = std::random_access_iterator_tag;
-      /// Number of fields
-      static const auto number_of_fields = Object::number_of_fields;
-
-      explicit __const_iterator() : base_class{}, m_container{*this} {}
-
-      // Similar constructors to those of std::tuple
-      template <class... Iterators>
-      explicit __const_iterator(Iterators const &... args)
-          : base_class{args...}, m_container{*this} {}
-
-      /// Constructors for cases with no arguments (default) and with
-      /// iterators
-      template <class... UIterators>
-      __const_iterator(UIterators &&... args)
-          : base_class{args...}, m_container{*this} {}
-
-      __const_iterator(const __const_iterator &other)
-          : base_class(other), m_container{*this} {}
-      __const_iterator(__const_iterator &&other)
-          : base_class(other), m_container{*this} {}
-
-      __const_iterator &operator=(const __const_iterator &other) {
-        base_class::operator=(other);
-        return *this;
-      }
-
-      __const_iterator &operator=(__const_iterator &&other) {
-        base_class::operator=(other);
-        return *this;
-      }
-
-      /// Dereference operator
-      reference_type operator*() const { return m_container; }
-
-      /// Access operator
-      pointer_type operator->() const { return &m_container; }
-
-      /// Increment operator
-      __const_iterator &operator++() {
-
-        this->next_impl(std::make_index_sequence<number_of_fields>{});
-
-        return *this;
-      }
-
-      /// Increment operator (copy)
-      __const_iterator operator++(int) {
-
-        __const_iterator copy{*this};
-
-        this->next_impl(std::make_index_sequence<number_of_fields>{});
-
-        return copy;
-      }
-
-      /// Decrement operator
-      __const_iterator &operator--() {
-
-        this->prev_impl(std::make_index_sequence<number_of_fields>{});
-
-        return *this;
-      }
-
-      /// Decrement operator (copy)
-      __const_iterator operator--(int) {
-
-        __const_iterator copy{*this};
-
-        this->prev_impl(std::make_index_sequence<number_of_fields>{});
-
-        return copy;
-      }
-
-      /// Add operator
-      __const_iterator operator+(size_t n) const {
-        __const_iterator copy{*this};
-        return copy += n;
-      }
-
-      /// Add operator (inplace)
-      __const_iterator &operator+=(size_t n) {
-        return this->add_impl(n, std::make_index_sequence<number_of_fields>{});
-      }
-
-      /// Subtract operator
-      __const_iterator operator-(size_t n) const {
-        __const_iterator copy{*this};
-        return copy += n;
-      }
-
-      /// Distance to another iterator
-      difference_type operator-(__const_iterator const &other) const {
-        if constexpr (number_of_fields == 0)
-          return 0;
-        else
-          return std::get<0>(*this) - std::get<0>(other);
-      }
-
-      /// Add operator (inplace)
-      __const_iterator &operator-=(size_t n) {
-        return this->sub_impl(n, std::make_index_sequence<number_of_fields>{});
-      }
-
-      /// Comparison operator (equality)
-      template <class Iterator>
-      typename std::enable_if<(number_of_fields == Iterator::number_of_fields),
-                              bool>::type
-      operator==(Iterator const &other) const {
-
-        if constexpr (number_of_fields == 0)
-          return true;
-        else
-          return std::get<0>(*this) == std::get<0>(other);
-      }
-
-      /// Comparison operator (inequality)
-      template <class Iterator>
-      typename std::enable_if<(number_of_fields == Iterator::number_of_fields),
-                              bool>::type
-      operator!=(Iterator const &other) const {
-
-        if constexpr (number_of_fields == 0)
-          return true;
-        else
-          return std::get<0>(*this) != std::get<0>(other);
-      }
-
-      template <class Iterator> bool operator<(Iterator const &other) {
-        if constexpr (number_of_fields == 0)
-          return true;
-        else
-          return std::get<0>(*this) < std::get<0>(other);
-      }
-
-      template <class Iterator> bool operator<=(Iterator const &other) {
-        if constexpr (number_of_fields == 0)
-          return true;
-        else
-          return std::get<0>(*this) <= std::get<0>(other);
-      }
-
-      template <class Iterator> bool operator>(Iterator const &other) {
-        if constexpr (number_of_fields == 0)
-          return true;
-        else
-          return std::get<0>(*this) > std::get<0>(other);
-      }
-
-      template <class Iterator> bool operator>=(Iterator const &other) {
-        if constexpr (number_of_fields == 0)
-          return true;
-        else
-          return std::get<0>(*this) >= std::get<0>(other);
-      }
-
-    protected:
-      /// Container instance
-      value_type m_container;
-
-    private:
-      /// Implementation of the add function
-      template <size_t... I>
-      inline __const_iterator &add_impl(size_t n, std::index_sequence<I...>) {
-        (std::next(std::get<I>(*this), n), ...);
-        return *this;
-      }
-
-      /// Implementation of the subtract function
-      template <size_t... I>
-      inline __const_iterator &sub_impl(size_t n, std::index_sequence<I...>) {
-        (std::prev(std::get<I>(*this), n), ...);
-        return *this;
-      }
-
-      /// Implementation of the function to access the next element
-      template <size_t... I>
-      constexpr void next_impl(std::index_sequence<I...>) {
-
-        (++std::get<I>(*this), ...);
-      }
-
-      /// Implementation of the function to access the previous element
-      template <size_t... I>
-      constexpr void prev_impl(std::index_sequence<I...>) {
-
-        (--std::get<I>(*this), ...);
-      }
-    };
+    template <class Columns, class Object>
+    using __const_iterator = __iterator<Columns const, Object>;
   } // namespace core
 } // namespace smit
 #endif
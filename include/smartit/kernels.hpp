@@ -0,0 +1,119 @@
+#ifndef SMARTIT_KERNELS_HPP
+#define SMARTIT_KERNELS_HPP
+
+#include <cmath>
+
+#include "simd.hpp"
+#include "types.hpp"
+
+namespace smit {
+
+  /**
+   * @brief Functions operating on whole containers of smit::point_3d objects
+   *
+   * The kernels process the elements in batches of the native SIMD width.
+   * Inputs must have the same size, and the outputs must have room for as
+   * many elements as the inputs. Scalar results are written to contiguous
+   * columns, given by a pointer to the first element. Containers stating
+   * the alignment of their columns are accessed with aligned loads and
+   * stores.
+   */
+  namespace kernels {
+
+    /// Dot product of the elements of two containers
+    template <class A, class B, class T>
+    void dot(A const &a, B const &b, T *out) {
+      core::_f_for_each_batch_of<
+          core::batch_width<typename A::value_type, A, B>>(
+          a.size(),
+          [out](size_t i, size_t n, auto const &ba, auto const &bb) {
+            core::_f_store_field(smit::dot(ba, bb), out, i, n);
+          },
+          a, b);
+    }
+
+    /// Cross product of the elements of two containers
+    template <class A, class B, class C>
+    void cross(A const &a, B const &b, C &out) {
+      core::_f_for_each_batch_of<
+          core::batch_width<typename A::value_type, A, B, C>>(
+          a.size(),
+          [&out](size_t i, size_t n, auto const &ba, auto const &bb) {
+            core::_f_store_batch<core::column_alignment<C>::value>(
+                smit::cross(ba, bb), core::_f_columns(out), i, n);
+          },
+          a, b);
+    }
+
+    /// Square of the module of the elements of a container
+    template <class A, class T> void mod2(A const &a, T *out) {
+      core::_f_for_each_batch_of<core::batch_width<typename A::value_type, A>>(
+          a.size(),
+          [out](size_t i, size_t n, auto const &ba) {
+            core::_f_store_field(ba.mod2(), out, i, n);
+          },
+          a);
+    }
+
+    /// Module of the elements of a container
+    template <class A, class T> void norm(A const &a, T *out) {
+      core::_f_for_each_batch_of<core::batch_width<typename A::value_type, A>>(
+          a.size(),
+          [out](size_t i, size_t n, auto const &ba) {
+            using std::sqrt;
+            core::_f_store_field(sqrt(ba.mod2()), out, i, n);
+          },
+          a);
+    }
+
+    /// Unitary vectors along the elements of a container
+    template <class A, class C> void normalize(A const &a, C &out) {
+      core::_f_for_each_batch_of<
+          core::batch_width<typename A::value_type, A, C>>(
+          a.size(),
+          [&out](size_t i, size_t n, auto ba) {
+            using std::sqrt;
+            auto const m = sqrt(ba.mod2());
+            ba.x() /= m;
+            ba.y() /= m;
+            ba.z() /= m;
+            core::_f_store_batch<core::column_alignment<C>::value>(
+                ba, core::_f_columns(out), i, n);
+          },
+          a);
+    }
+
+    /// Normalize the elements of a container
+    template <class A> void normalize(A &a) {
+      a.for_each_batch([](auto &ba) {
+        using std::sqrt;
+        auto const m = sqrt(ba.mod2());
+        ba.x() /= m;
+        ba.y() /= m;
+        ba.z() /= m;
+      });
+    }
+
+    /// Angle with respect to the X axis of the elements of a container
+    template <class A, class T> void phi(A const &a, T *out) {
+      core::_f_for_each_batch_of<core::batch_width<typename A::value_type, A>>(
+          a.size(),
+          [out](size_t i, size_t n, auto const &ba) {
+            core::_f_store_field(ba.phi(), out, i, n);
+          },
+          a);
+    }
+
+    /// Angle with respect to the Z axis of the elements of a container
+    template <class A, class T> void theta(A const &a, T *out) {
+      core::_f_for_each_batch_of<core::batch_width<typename A::value_type, A>>(
+          a.size(),
+          [out](size_t i, size_t n, auto const &ba) {
+            core::_f_store_field(ba.theta(), out, i, n);
+          },
+          a);
+    }
+  } // namespace kernels
+} // namespace smit
+
+#endif // SMARTIT_KERNELS_HPP
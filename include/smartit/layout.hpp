@@ -0,0 +1,34 @@
+#ifndef SMARTIT_LAYOUT_HPP
+#define SMARTIT_LAYOUT_HPP
+
+#include <cstddef>
+
+namespace smit {
+
+  /**
+   * @brief Policies defining how the elements of a container are stored
+   *
+   * The same data object can be stored with any of them, and the elements
+   * are accessed through the same container types, so the code using the
+   * prototype does not depend on the layout.
+   *
+   * @see smit::container
+   */
+  namespace layout {
+
+    /// Structure of arrays: each arithmetic field is stored in a column
+    struct soa {};
+
+    /// Array of structures of arrays: the elements are stored in tiles of W
+    /// elements, each field being contiguous within a tile
+    template <size_t W> struct aosoa {
+      /// Number of elements in a tile
+      static constexpr size_t width = W;
+    };
+
+    /// Array of structures: the fields of each element are contiguous
+    using aos = aosoa<1>;
+  } // namespace layout
+} // namespace smit
+
+#endif // SMARTIT_LAYOUT_HPP
@@ -0,0 +1,60 @@
+#ifndef SMARTIT_MEMORY_HPP
+#define SMARTIT_MEMORY_HPP
+
+#include <cstddef>
+
+namespace smit {
+
+  namespace core {
+
+    /// Size of a cache line (in bytes)
+    constexpr size_t cache_line_size = 64;
+
+    /**
+     * @brief Unit of allocation for the contiguous storages
+     *
+     * Allocating arrays of this type guarantees that the memory block is
+     * aligned to a cache line.
+     */
+    struct alignas(cache_line_size) __cache_line {
+      unsigned char bytes[cache_line_size];
+    };
+
+    /// Number of cache lines needed to store "n" elements of the given type
+    template <class Type> constexpr size_t _f_cache_lines(size_t n) {
+      return (n * sizeof(Type) + cache_line_size - 1) / cache_line_size;
+    }
+
+    /**
+     * @brief Tell the compiler that a pointer is aligned to A bytes
+     *
+     * The alignment must be a power of two, and the pointer must actually
+     * be aligned, or the behaviour is undefined.
+     */
+    template <size_t A, class Type> inline Type *_f_assume_aligned(Type *ptr) {
+      static_assert(A != 0 && (A & (A - 1)) == 0,
+                    "The alignment must be a power of two");
+#if defined(__GNUC__)
+      return static_cast<Type *>(__builtin_assume_aligned(ptr, A));
+#else
+      return ptr;
+#endif
+    }
+
+    /// Number of elements ahead of the current one whose memory is
+    /// prefetched when accessing a column at random positions
+    constexpr size_t prefetch_distance = 16;
+
+    /// Hint the processor to bring the memory at the given address to the
+    /// cache, for reading or for writing
+    template <bool Write = false> inline void _f_prefetch(void const *ptr) {
+#if defined(__GNUC__)
+      __builtin_prefetch(ptr, Write);
+#else
+      (void)ptr;
+#endif
+    }
+  } // namespace core
+} // namespace smit
+
+#endif // SMARTIT_MEMORY_HPP
@@ -0,0 +1,409 @@
+#ifndef SMARTIT_MMAP_VECTOR_HPP
+#define SMARTIT_MMAP_VECTOR_HPP
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "expression.hpp"
+#include "format.hpp"
+#include "iterator.hpp"
+#include "memory.hpp"
+#include "simd.hpp"
+#include "vector.hpp"
+
+namespace smit {
+
+  namespace core {
+
+    /**
+     * @brief Header of the files mapped by smit::mmap_vector
+     *
+     * A file starts with this header, followed by one
+     * smit::core::__mmap_column per arithmetic field of the object (nested
+     * data objects are flattened depth-first). The columns come next, each
+     * starting at the offset recorded in its description, which is a
+     * multiple of the size of a cache line. All the values are stored with
+     * the byte order of the platform that wrote the file.
+     */
+    struct __mmap_header {
+      /// Identifier of the format ("SMITMAP" followed by a null character)
+      char magic[8];
+      /// Version of the format
+      std::uint32_t version;
+      /// Must be smit::core::byte_order_mark when read
+      std::uint32_t byte_order;
+      /// Number of elements
+      std::uint64_t size;
+      /// Number of columns
+      std::uint64_t number_of_columns;
+    };
+
+    /// Description of a column in the files mapped by smit::mmap_vector
+    struct __mmap_column {
+      /// Type of the values
+      __type_code type;
+      /// Position of the first value with respect to the start of the file
+      std::uint64_t offset;
+    };
+
+    /// Identifier of the files mapped by smit::mmap_vector
+    constexpr char mmap_magic[8] = "SMITMAP";
+
+    /// Version of the format of the files mapped by smit::mmap_vector
+    constexpr std::uint32_t mmap_version = 1;
+  } // namespace core
+
+  /// Access mode of the files mapped by smit::mmap_vector
+  enum class mmap_mode { read_only, read_write };
+
+  /**
+   * @brief Vector whose columns are stored in a memory-mapped file
+   *
+   * Opening a file only maps it in memory, so the cost does not depend on
+   * its size, and the pages are loaded on demand as the elements are
+   * accessed. The elements are accessed through the same iterators and
+   * container types as in smit::vector. Containers opened in read-only mode
+   * only give constant access to the elements. Changes made in read-write
+   * mode are written to the file by the operating system, or on demand with
+   * smit::mmap_vector::flush.
+   *
+   * The number of elements is fixed when the file is created. Errors
+   * accessing the file are reported with std::system_error, and files that
+   * do not match the format or the fields of the object with
+   * std::runtime_error.
+   *
+   * @see smit::core::__mmap_header
+   */
+  template <class Object, mmap_mode Mode = mmap_mode::read_write>
+  class mmap_vector : public core::__vector_columns<Object> {
+
+  public:
+    /// Base class
+    using base_class = core::__vector_columns<Object>;
+    /// Whether the elements can be modified
+    static constexpr bool is_writable = (Mode == mmap_mode::read_write);
+    /// Columns accessed by the iterators, constant in read-only mode
+    using columns_type =
+        std::conditional_t<is_writable, base_class, base_class const>;
+    /// Alignment (in bytes) of the first element of each column
+    static constexpr size_t column_alignment = core::cache_line_size;
+    /// Type of the elements
+    using value_type = Object;
+    /// Vector iterator
+    using iterator = core::__iterator<columns_type, Object>;
+    /// Vector constant iterator
+    using const_iterator = core::__const_iterator<base_class, Object>;
+    /// Type of the container returned on access
+    using reference = typename iterator::reference;
+    /// Type of the container returned on access (constant)
+    using const_reference = typename const_iterator::reference;
+    /// Type of the distance between iterators
+    using difference_type = typename iterator::difference_type;
+
+    /// Map an existing file
+    explicit mmap_vector(std::string const &path) : base_class{} {
+      this->open(path);
+    }
+
+    /// Create (or overwrite) a file storing n elements set to zero
+    mmap_vector(std::string const &path, size_t n) : base_class{} {
+      this->create(path, n);
+    }
+
+    /// Create (or overwrite) a file storing a copy of the elements of a
+    /// container
+    template <class Container,
+              class = std::enable_if_t<core::is_container<Container>::value>>
+    mmap_vector(std::string const &path, Container const &other)
+        : base_class{} {
+      this->create(path, other.size());
+      for (size_t i = 0; i < m_size; ++i)
+        core::_f_assign(this->at(i), other[i]);
+    }
+
+    mmap_vector(mmap_vector const &) = delete;
+    mmap_vector &operator=(mmap_vector const &) = delete;
+
+    /// Move constructor
+    mmap_vector(mmap_vector &&other) : base_class{} { this->swap(other); }
+
+    /// Move assignment operator
+    mmap_vector &operator=(mmap_vector &&other) {
+      this->swap(other);
+      return *this;
+    }
+
+    /// Unmap the file
+    ~mmap_vector() { this->unmap(); }
+
+    inline reference operator[](size_t i) { return this->at(i); }
+
+    inline const_reference operator[](size_t i) const { return this->at(i); }
+
+    /// Returns a reference at position i in the vector
+    reference at(size_t i) {
+      return reference(static_cast<columns_type &>(*this), i);
+    }
+
+    /// Returns a reference at position i in the vector (constant)
+    const_reference at(size_t i) const {
+      return const_reference(static_cast<base_class const &>(*this), i);
+    }
+
+    /// Test whether the vector is empty
+    inline bool empty() const { return this->size() == 0; }
+
+    /// Get the size of the vector
+    inline size_t size() const { return m_size; }
+
+    /// Write the changes to the file, waiting for the operation to finish
+    void flush() {
+      static_assert(is_writable, "Files opened in read-only mode can not "
+                                 "be modified");
+      if (m_data != nullptr && ::msync(m_data, m_bytes, MS_SYNC) != 0)
+        throw std::system_error(errno, std::generic_category(),
+                                "smit::mmap_vector: unable to flush");
+    }
+
+    /// Swap the contents of two vectors
+    void swap(mmap_vector &other) {
+      std::swap(static_cast<base_class &>(*this),
+                static_cast<base_class &>(other));
+      std::swap(m_data, other.m_data);
+      std::swap(m_bytes, other.m_bytes);
+      std::swap(m_size, other.m_size);
+    }
+
+    /// Call a function on batches of W consecutive elements. The batches
+    /// are not stored back in read-only mode.
+    template <size_t W = simd::default_width<Object>, class Function>
+    void for_each_batch(Function &&f) {
+      core::_f_for_each_batch<W, Object, column_alignment>(
+          static_cast<columns_type &>(*this), m_size, f);
+    }
+
+    /// Call a function on batches of W consecutive elements (constant). The
+    /// batches are not stored back in the vector.
+    template <size_t W = simd::default_width<Object>, class Function>
+    void for_each_batch(Function &&f) const {
+      core::_f_for_each_batch<W, Object, column_alignment>(
+          static_cast<base_class const &>(*this), m_size, f);
+    }
+
+    /// Begining of the vector
+    iterator begin() { return {*this, 0}; }
+
+    /// Begining of the vector (constant)
+    const_iterator begin() const { return {*this, 0}; }
+
+    /// Begining of the vector (constant)
+    const_iterator cbegin() const { return {*this, 0}; }
+
+    /// End of the vector
+    iterator end() { return {*this, difference_type(m_size)}; }
+
+    /// End of the vector (constant)
+    const_iterator end() const { return {*this, difference_type(m_size)}; }
+
+    /// End of the vector (constant)
+    const_iterator cend() const { return {*this, difference_type(m_size)}; }
+
+  private:
+    /// Codes of the types of the columns
+    static constexpr auto type_codes = core::column_type_codes<Object>;
+
+    /// Number of columns
+    static constexpr size_t number_of_columns = type_codes.size();
+
+    /// Position of the first column in the file
+    static constexpr size_t data_offset =
+        core::_f_cache_lines<unsigned char>(
+            sizeof(core::__mmap_header) +
+            number_of_columns * sizeof(core::__mmap_column)) *
+        core::cache_line_size;
+
+    /// Mapped file
+    unsigned char *m_data = nullptr;
+    /// Size of the mapped file (in bytes)
+    size_t m_bytes = 0;
+    /// Number of elements
+    size_t m_size = 0;
+
+    /// Throw an exception reporting the last error of the system
+    [[noreturn]] static void system_error(std::string const &what,
+                                          std::string const &path) {
+      throw std::system_error(errno, std::generic_category(),
+                              "smit::mmap_vector: unable to " + what +
+                                  " \"" + path + "\"");
+    }
+
+    /// Throw an exception reporting an invalid file
+    [[noreturn]] static void format_error(std::string const &what,
+                                          std::string const &path) {
+      throw std::runtime_error("smit::mmap_vector: " + what + " in \"" +
+                               path + "\"");
+    }
+
+    /// Map the given number of bytes of an open file
+    void map(int fd, size_t bytes, std::string const &path) {
+
+      int const protection =
+          is_writable ? PROT_READ | PROT_WRITE : PROT_READ;
+
+      void *data = ::mmap(nullptr, bytes, protection, MAP_SHARED, fd, 0);
+
+      if (data == MAP_FAILED) {
+        int const error = errno;
+        ::close(fd);
+        errno = error;
+        system_error("map", path);
+      }
+
+      ::close(fd);
+
+      m_data = static_cast<unsigned char *>(data);
+      m_bytes = bytes;
+    }
+
+    /// Point the columns to the file, following the descriptions
+    void assign(core::__mmap_column const *columns) {
+      size_t k = 0;
+      core::_f_for_each_column(
+          [this, columns, &k](auto &column) {
+            using type = std::remove_reference_t<decltype(*column)>;
+            column = reinterpret_cast<type *>(m_data + columns[k++].offset);
+          },
+          static_cast<base_class &>(*this));
+    }
+
+    /// Map an existing file, checking that it matches the object
+    void open(std::string const &path) {
+
+      int const fd = ::open(path.c_str(), is_writable ? O_RDWR : O_RDONLY);
+      if (fd < 0)
+        system_error("open", path);
+
+      struct stat info;
+      if (::fstat(fd, &info) != 0) {
+        int const error = errno;
+        ::close(fd);
+        errno = error;
+        system_error("read the size of", path);
+      }
+
+      size_t const bytes = info.st_size;
+      if (bytes < data_offset) {
+        ::close(fd);
+        format_error("header too short", path);
+      }
+
+      this->map(fd, bytes, path);
+
+      try {
+        this->check(path);
+      } catch (...) {
+        this->unmap();
+        m_data = nullptr;
+        throw;
+      }
+    }
+
+    /// Check that the mapped file matches the object, and point the columns
+    /// to it
+    void check(std::string const &path) {
+
+      core::__mmap_header header;
+      std::memcpy(&header, m_data, sizeof(header));
+
+      if (std::memcmp(header.magic, core::mmap_magic, sizeof(header.magic)))
+        format_error("invalid identifier", path);
+      if (header.version != core::mmap_version)
+        format_error("unsupported version", path);
+      if (header.byte_order != core::byte_order_mark)
+        format_error("different byte order", path);
+      if (header.number_of_columns != number_of_columns)
+        format_error("wrong number of columns", path);
+
+      core::__mmap_column columns[number_of_columns];
+      std::memcpy(columns, m_data + sizeof(header), sizeof(columns));
+
+      for (size_t k = 0; k < number_of_columns; ++k) {
+        if (columns[k].type != type_codes[k])
+          format_error("wrong type of column " + std::to_string(k), path);
+        if (columns[k].offset % core::cache_line_size != 0 ||
+            columns[k].offset < data_offset || columns[k].offset > m_bytes ||
+            header.size > (m_bytes - columns[k].offset) / columns[k].type.size)
+          format_error("invalid offset of column " + std::to_string(k),
+                       path);
+      }
+
+      m_size = header.size;
+
+      this->assign(columns);
+    }
+
+    /// Create a file with room for n elements, set to zero
+    void create(std::string const &path, size_t n) {
+
+      static_assert(is_writable,
+                    "Files can only be created in read-write mode");
+
+      core::__mmap_header header{};
+      std::memcpy(header.magic, core::mmap_magic, sizeof(header.magic));
+      header.version = core::mmap_version;
+      header.byte_order = core::byte_order_mark;
+      header.size = n;
+      header.number_of_columns = number_of_columns;
+
+      core::__mmap_column columns[number_of_columns];
+
+      size_t bytes = data_offset;
+      for (size_t k = 0; k < number_of_columns; ++k) {
+        columns[k].type = type_codes[k];
+        columns[k].offset = bytes;
+        bytes += core::_f_cache_lines<unsigned char>(n * type_codes[k].size) *
+                 core::cache_line_size;
+      }
+
+      int const fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+      if (fd < 0)
+        system_error("create", path);
+
+      // the file is filled with zeros
+      if (::ftruncate(fd, bytes) != 0) {
+        int const error = errno;
+        ::close(fd);
+        errno = error;
+        system_error("resize", path);
+      }
+
+      this->map(fd, bytes, path);
+
+      std::memcpy(m_data, &header, sizeof(header));
+      std::memcpy(m_data + sizeof(header), columns, sizeof(columns));
+
+      m_size = n;
+
+      this->assign(columns);
+    }
+
+    /// Unmap the file
+    void unmap() {
+      if (m_data != nullptr)
+        ::munmap(m_data, m_bytes);
+    }
+  };
+} // namespace smit
+
+#endif // SMARTIT_MMAP_VECTOR_HPP
@@ -0,0 +1,296 @@
+#ifndef SMARTIT_PROJECTION_HPP
+#define SMARTIT_PROJECTION_HPP
+
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "iterator.hpp"
+#include "simd.hpp"
+#include "value.hpp"
+
+namespace smit {
+
+  namespace core {
+
+    /**
+     * @brief Reference to a column of the arithmetic field of a container
+     *
+     * Follows the column of the container, so it remains valid if the
+     * container is reallocated.
+     */
+    template <class Column> class __column_view {
+
+    public:
+      /// Build the view from the column
+      __column_view(Column &column) : m_column{&column} {}
+
+      /// Access the value of the given element
+      decltype(auto) operator[](size_t i) const { return (*m_column)[i]; }
+
+    protected:
+      /// Column of the container
+      Column *m_column;
+    };
+
+    /// Whether the field at position J is part of a projection
+    template <size_t... I>
+    constexpr bool _f_is_selected(size_t j, std::index_sequence<I...>) {
+      return ((j == I) || ...);
+    }
+
+    /// Type of a field in a projection
+    template <class Object, size_t J, class Selection>
+    using projected_field_t = std::conditional_t<
+        _f_is_selected(J, Selection{}),
+        utils::tuple_element_for_t<J, typename Object::types>,
+        __skipped_field>;
+
+    template <class Object, class Selection, size_t... J>
+    constexpr auto _f_projected_object(std::index_sequence<J...>) {
+      return utils::type_wrapper<
+          data_object<traits::extract_prototype<Object>::template type,
+                      projected_field_t<Object, J, Selection>...>>{};
+    }
+
+    /// Data object with the fields excluded from a projection replaced by
+    /// smit::core::__skipped_field
+    template <class Object, class Selection>
+    using projected_object_t =
+        typename decltype(_f_projected_object<Object, Selection>(
+            std::make_index_sequence<Object::number_of_fields>{}))::type;
+
+    template <class Columns, class Object, class Selection>
+    class __projected_columns;
+
+    /// Type of the column of the field at position J in a projection
+    template <class Columns, class Object, size_t J, class Selection>
+    constexpr auto _f_projected_column() {
+
+      using field_type = utils::tuple_element_for_t<J, typename Object::types>;
+
+      using column_type = std::remove_reference_t<decltype(
+          std::get<J>(std::declval<Columns &>()))>;
+
+      if constexpr (!_f_is_selected(J, Selection{}))
+        return utils::type_wrapper<__skipped_field>{};
+      else if constexpr (std::is_arithmetic<field_type>::value)
+        return utils::type_wrapper<__column_view<column_type>>{};
+      else
+        return utils::type_wrapper<__projected_columns<
+            column_type, field_type,
+            std::make_index_sequence<field_type::number_of_fields>>>{};
+    }
+
+    template <class Columns, class Object, size_t J, class Selection>
+    using projected_column_t = typename decltype(
+        _f_projected_column<Columns, Object, J, Selection>())::type;
+
+    template <class Columns, class Object, class Selection, size_t... J>
+    constexpr auto _f_projected_columns_base(std::index_sequence<J...>) {
+      return utils::type_wrapper<std::tuple<
+          projected_column_t<Columns, Object, J, Selection>...>>{};
+    }
+
+    /// Tuple of the columns of a projection
+    template <class Columns, class Object, class Selection>
+    using projected_columns_base_t =
+        typename decltype(_f_projected_columns_base<Columns, Object, Selection>(
+            std::make_index_sequence<Object::number_of_fields>{}))::type;
+
+    /**
+     * @brief Columns of the fields of an object selected in a projection
+     *
+     * Refers to the columns of a container. Only the selected fields are
+     * accessed on dereference or loaded in batches, nested data objects
+     * being fully selected.
+     */
+    template <class Columns, class Object, class Selection>
+    class __projected_columns
+        : public projected_columns_base_t<Columns, Object, Selection> {
+
+    public:
+      /// Tuple of columns
+      using base_class = projected_columns_base_t<Columns, Object, Selection>;
+      /// Object with the selected fields
+      using object_type = projected_object_t<Object, Selection>;
+      /// Type of the container returned on access
+      using reference =
+          __container_type<traits::extract_prototype<Object>::template type,
+                           false, typename object_type::types>;
+      /// Type of the container returned on access (constant)
+      using const_reference =
+          __container_type<traits::extract_prototype<Object>::template type,
+                           true, typename object_type::types>;
+
+      /// Build the projection from the columns of a container
+      __projected_columns(Columns &columns)
+          : base_class{make_base(
+                columns,
+                std::make_index_sequence<Object::number_of_fields>{})} {}
+
+      /// Access the given element
+      reference operator[](size_t i) { return reference(*this, i); }
+
+      /// Access the given element (constant)
+      const_reference operator[](size_t i) const {
+        return const_reference(*this, i);
+      }
+
+    private:
+      /// Implementation of the constructor
+      template <size_t... J>
+      static base_class make_base(Columns &columns,
+                                  std::index_sequence<J...>) {
+        return {make_column<J>(columns)...};
+      }
+
+      /// Build the column of the field at position J
+      template <size_t J>
+      static projected_column_t<Columns, Object, J, Selection>
+      make_column(Columns &columns) {
+        if constexpr (_f_is_selected(J, Selection{}))
+          return {std::get<J>(columns)};
+        else
+          return {};
+      }
+    };
+
+    /// Columns of a container, keeping the constness
+    template <class Container>
+    using container_columns_t =
+        std::conditional_t<std::is_const<Container>::value,
+                           typename Container::base_class const,
+                           typename Container::base_class>;
+  } // namespace core
+
+  /**
+   * @brief View of a subset of the fields of a container
+   *
+   * Iterators, elements and batches only refer to the selected fields, so
+   * loops reading a few fields of wide objects do not touch the rest. The
+   * elements keep the prototype of the container, so its functions can be
+   * used as long as they only access the selected fields. The view follows
+   * the container if it is reallocated, but it must not outlive it.
+   *
+   * @see smit::project
+   */
+  template <class Container, size_t... I>
+  class projection
+      : public core::__projected_columns<
+            core::container_columns_t<Container>,
+            typename Container::value_type, std::index_sequence<I...>> {
+
+  public:
+    /// Base class
+    using base_class =
+        core::__projected_columns<core::container_columns_t<Container>,
+                                  typename Container::value_type,
+                                  std::index_sequence<I...>>;
+    /// Columns of the view, constant if the container is constant
+    using columns_type = std::conditional_t<std::is_const<Container>::value,
+                                            base_class const, base_class>;
+    /// Type of the elements
+    using value_type = typename base_class::object_type;
+    /// Iterator
+    using iterator = core::__iterator<columns_type, value_type>;
+    /// Constant iterator
+    using const_iterator = core::__const_iterator<base_class, value_type>;
+    /// Type of the container returned on access
+    using reference = typename iterator::reference;
+    /// Type of the container returned on access (constant)
+    using const_reference = typename const_iterator::reference;
+    /// Type of the distance between iterators
+    using difference_type = typename iterator::difference_type;
+
+    /// Number of consecutive elements stored contiguously for each field
+    static constexpr size_t tile_width =
+        core::max_batch_width<std::remove_const_t<Container>>::value;
+    /// Alignment (in bytes) of the first element of each column
+    static constexpr size_t column_alignment =
+        core::column_alignment<std::remove_const_t<Container>>::value;
+
+    /// Build the view from a container
+    projection(Container &container)
+        : base_class{static_cast<core::container_columns_t<Container> &>(
+              container)},
+          m_container{&container} {}
+
+    inline reference operator[](size_t i) { return *(this->begin() + i); }
+
+    inline const_reference operator[](size_t i) const {
+      return *(this->cbegin() + i);
+    }
+
+    /// Number of elements
+    inline size_t size() const { return m_container->size(); }
+
+    /// Test whether the view is empty
+    inline bool empty() const { return this->size() == 0; }
+
+    /// Call a function on batches of W consecutive elements, only loading
+    /// (and storing) the selected fields
+    template <size_t W = core::batch_width<value_type, Container>,
+              class Function>
+    void for_each_batch(Function &&f) {
+      core::_f_for_each_batch<W, value_type, column_alignment>(
+          static_cast<columns_type &>(*this), this->size(), f);
+    }
+
+    /// Call a function on batches of W consecutive elements (constant). The
+    /// batches are not stored back in the container.
+    template <size_t W = core::batch_width<value_type, Container>,
+              class Function>
+    void for_each_batch(Function &&f) const {
+      core::_f_for_each_batch<W, value_type, column_alignment>(
+          static_cast<base_class const &>(*this), this->size(), f);
+    }
+
+    /// Begining of the view
+    iterator begin() { return {*this, 0}; }
+
+    /// Begining of the view (constant)
+    const_iterator begin() const { return {*this, 0}; }
+
+    /// Begining of the view (constant)
+    const_iterator cbegin() const { return {*this, 0}; }
+
+    /// End of the view
+    iterator end() { return {*this, difference_type(this->size())}; }
+
+    /// End of the view (constant)
+    const_iterator end() const {
+      return {*this, difference_type(this->size())};
+    }
+
+    /// End of the view (constant)
+    const_iterator cend() const {
+      return {*this, difference_type(this->size())};
+    }
+
+  private:
+    /// Container
+    Container *m_container;
+  };
+
+  /**
+   * @brief Build a view of the fields at positions I... of a container
+   *
+   * @code
+   * smit::vector<smit::point_3d<float>> v(n);
+   * for (auto p : smit::project<0, 1>(v))
+   *   p.x() = p.y(); // z() can not be used
+   * @endcode
+   *
+   * @see smit::projection
+   */
+  template <size_t... I, class Container>
+  projection<Container, I...> project(Container &container) {
+    static_assert(sizeof...(I) != 0, "At least one field must be selected");
+    static_assert(((I < Container::value_type::number_of_fields) && ...),
+                  "Field index out of range");
+    return {container};
+  }
+} // namespace smit
+
+#endif // SMARTIT_PROJECTION_HPP
@@ -0,0 +1,584 @@
+#ifndef SMARTIT_REDUCTION_HPP
+#define SMARTIT_REDUCTION_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "execution.hpp"
+#include "expression.hpp"
+#include "simd.hpp"
+#include "value.hpp"
+#include "vector.hpp"
+
+namespace smit {
+
+  /**
+   * @brief Algorithms to add floating point values
+   *
+   * @see smit::sum
+   */
+  namespace summation {
+
+    /// Add the values in several SIMD accumulators
+    struct simple_strategy {};
+
+    /// Add the values in several SIMD accumulators, keeping track of the
+    /// rounding errors (Kahan summation). The errors are lost if the code is
+    /// compiled with unsafe floating point optimizations (-ffast-math).
+    struct kahan_strategy {};
+
+    /// Add the two halves of the values separately, recursively, so the
+    /// rounding error grows with the logarithm of the number of values
+    struct pairwise_strategy {};
+
+    /// Simple summation
+    constexpr simple_strategy simple{};
+    /// Kahan summation
+    constexpr kahan_strategy kahan{};
+    /// Pairwise summation
+    constexpr pairwise_strategy pairwise{};
+
+    /// Check whether a type is a summation strategy
+    template <class T> struct is_strategy : std::false_type {};
+
+    template <> struct is_strategy<simple_strategy> : std::true_type {};
+
+    template <> struct is_strategy<kahan_strategy> : std::true_type {};
+
+    template <> struct is_strategy<pairwise_strategy> : std::true_type {};
+
+    /// Value of smit::summation::is_strategy
+    template <class T>
+    constexpr bool is_strategy_v = is_strategy<std::decay_t<T>>::value;
+  } // namespace summation
+
+  namespace core {
+
+    /// Number of packs accumulated independently in the reduction loops,
+    /// hiding the latency of the operations
+    constexpr size_t reduction_accumulators = 4;
+
+    /// Number of values below which pairwise summation adds them directly
+    constexpr size_t pairwise_block = 256;
+
+    /// Largest value of a type (infinity if it has it), identity of the
+    /// minimum
+    template <class T> constexpr T _f_highest_value() {
+      if constexpr (std::numeric_limits<T>::has_infinity)
+        return std::numeric_limits<T>::infinity();
+      else
+        return std::numeric_limits<T>::max();
+    }
+
+    /// Lowest value of a type (minus infinity if it has it), identity of
+    /// the maximum
+    template <class T> constexpr T _f_lowest_value() {
+      if constexpr (std::numeric_limits<T>::has_infinity)
+        return -std::numeric_limits<T>::infinity();
+      else
+        return std::numeric_limits<T>::lowest();
+    }
+
+    /// Type of a field of an object, given by its position and, for nested
+    /// data objects, those of the fields inside them. The object itself if
+    /// no position is given.
+    template <class Object, size_t... I> struct field_value {
+      using type = Object;
+    };
+
+    template <class Object, size_t I, size_t... J>
+    struct field_value<Object, I, J...> {
+      using type = typename field_value<
+          std::tuple_element_t<I, decltype(_f_tuple_base(
+                                      std::declval<Object const &>()))>,
+          J...>::type;
+    };
+
+    /// Type of smit::core::field_value
+    template <class Object, size_t... I>
+    using field_value_t = typename field_value<Object, I...>::type;
+
+    /// Type of the mean and variance of values of the given type (double
+    /// precision for integral values, and for the integral fields of data
+    /// objects)
+    template <class T, class Enable = void> struct moment {
+      using type = std::conditional_t<std::is_integral<T>::value, double, T>;
+    };
+
+    template <class T>
+    struct moment<T, std::void_t<typename T::types>> {
+      template <class... Fields>
+      static constexpr auto make(utils::types_holder<Fields...>) {
+        return utils::type_wrapper<
+            data_object<traits::extract_prototype<T>::template type,
+                        typename moment<Fields>::type...>>{};
+      }
+
+      using type = typename decltype(make(typename T::types{}))::type;
+    };
+
+    /// Type of smit::core::moment
+    template <class T> using moment_t = typename moment<T>::type;
+
+    /// Columns of the field at the given position (see
+    /// smit::core::field_value), or all of them if no position is given
+    template <size_t... I, class Columns>
+    inline auto const &_f_select_columns(Columns const &columns) {
+      if constexpr (sizeof...(I) == 0)
+        return columns;
+      else
+        return _f_column<I...>(columns);
+    }
+
+    /// Add a value to a sum keeping track of the rounding error (works both
+    /// on packs and on scalars)
+    template <class V>
+    inline void _f_kahan_add(V &sum, V &compensation, V const &value) {
+      V const y = value - compensation;
+      V const t = sum + y;
+      compensation = (t - sum) - y;
+      sum = t;
+    }
+
+    /// Sum of a transformation of the values in [data, data + n), called on
+    /// packs of values
+    template <class T, class Transform>
+    inline T _f_simd_sum(T const *data, size_t n, Transform &t) {
+
+      constexpr size_t W = simd::native_width<T>;
+      constexpr size_t U = reduction_accumulators;
+
+      using pack_type = simd::pack<T, W>;
+
+      pack_type acc[U];
+
+      size_t i = 0;
+      for (; i + U * W <= n; i += U * W)
+        for (size_t u = 0; u < U; ++u)
+          acc[u] += t(pack_type::load(data + i + u * W));
+      for (; i + W <= n; i += W)
+        acc[0] += t(pack_type::load(data + i));
+      if (i < n)
+        acc[0] += simd::select(pack_type::mask_type::first(n - i),
+                               t(pack_type::load(data + i, n - i)),
+                               pack_type{});
+
+      for (size_t u = 1; u < U; ++u)
+        acc[0] += acc[u];
+
+      return simd::sum(acc[0]);
+    }
+
+    /// Sum of the values in [data, data + n) with Kahan summation
+    template <class T> inline T _f_kahan_sum(T const *data, size_t n) {
+
+      constexpr size_t W = simd::native_width<T>;
+      constexpr size_t U = reduction_accumulators;
+
+      using pack_type = simd::pack<T, W>;
+
+      pack_type sum[U], compensation[U];
+
+      size_t i = 0;
+      for (; i + U * W <= n; i += U * W)
+        for (size_t u = 0; u < U; ++u)
+          _f_kahan_add(sum[u], compensation[u],
+                       pack_type::load(data + i + u * W));
+      for (; i + W <= n; i += W)
+        _f_kahan_add(sum[0], compensation[0], pack_type::load(data + i));
+      if (i < n)
+        _f_kahan_add(sum[0], compensation[0],
+                     pack_type::load(data + i, n - i));
+
+      // the lanes are also added keeping track of the errors
+      T s = 0, c = 0;
+      for (size_t u = 0; u < U; ++u)
+        for (size_t l = 0; l < W; ++l) {
+          _f_kahan_add(s, c, sum[u][l]);
+          _f_kahan_add(s, c, T(-compensation[u][l]));
+        }
+
+      return s;
+    }
+
+    /// Sum of a transformation of the values in [data, data + n) with
+    /// pairwise summation
+    template <class T, class Transform>
+    inline T _f_pairwise_sum(T const *data, size_t n, Transform &t) {
+
+      if (n <= pairwise_block)
+        return _f_simd_sum(data, n, t);
+
+      // the first half is a multiple of the number of lanes
+      constexpr size_t W = simd::native_width<T>;
+      size_t const half = n / 2 / W * W;
+
+      return _f_pairwise_sum(data, half, t) +
+             _f_pairwise_sum(data + half, n - half, t);
+    }
+
+    /// Sum of the values in [data, data + n). Integral values are always
+    /// added with smit::summation::simple.
+    template <class Strategy, class T>
+    inline T _f_sum(Strategy, T const *data, size_t n) {
+
+      auto identity = [](auto const &x) { return x; };
+
+      if constexpr (std::is_integral<T>::value ||
+                    std::is_same<Strategy, summation::simple_strategy>::value)
+        return _f_simd_sum(data, n, identity);
+      else if constexpr (std::is_same<Strategy,
+                                      summation::kahan_strategy>::value)
+        return _f_kahan_sum(data, n);
+      else
+        return _f_pairwise_sum(data, n, identity);
+    }
+
+    /// Sum of a transformation of the values in [data, data + n), with the
+    /// precision of smit::core::moment_t. The transformation is called on
+    /// packs of floating point values, and on each value otherwise.
+    template <class T, class Transform>
+    inline moment_t<T> _f_moment_sum(T const *data, size_t n, Transform &t) {
+
+      if constexpr (std::is_floating_point<T>::value)
+        return _f_pairwise_sum(data, n, t);
+      else {
+        constexpr size_t U = reduction_accumulators;
+
+        double acc[U] = {};
+
+        size_t i = 0;
+        for (; i + U <= n; i += U)
+          for (size_t u = 0; u < U; ++u)
+            acc[u] += t(double(data[i + u]));
+        for (; i < n; ++i)
+          acc[0] += t(double(data[i]));
+
+        for (size_t u = 1; u < U; ++u)
+          acc[0] += acc[u];
+
+        return acc[0];
+      }
+    }
+
+    /**
+     * @brief Minimum and maximum of the values in [data, data + n)
+     *
+     * Only the extrema requested are computed, the other being the
+     * identity. NaN values are ignored.
+     */
+    template <bool Min, bool Max, class T>
+    inline std::pair<T, T> _f_extrema(T const *data, size_t n) {
+
+      constexpr size_t W = simd::native_width<T>;
+      constexpr size_t U = reduction_accumulators;
+
+      using pack_type = simd::pack<T, W>;
+
+      T lo = _f_highest_value<T>(), hi = _f_lowest_value<T>();
+
+      pack_type pmin[U], pmax[U];
+      for (size_t u = 0; u < U; ++u) {
+        pmin[u] = lo;
+        pmax[u] = hi;
+      }
+
+      size_t i = 0;
+      for (; i + U * W <= n; i += U * W)
+        for (size_t u = 0; u < U; ++u) {
+          auto const p = pack_type::load(data + i + u * W);
+          if constexpr (Min)
+            pmin[u] = simd::min(pmin[u], p);
+          if constexpr (Max)
+            pmax[u] = simd::max(pmax[u], p);
+        }
+
+      for (size_t u = 0; u < U; ++u)
+        for (size_t l = 0; l < W; ++l) {
+          lo = std::min(lo, pmin[u][l]);
+          hi = std::max(hi, pmax[u][l]);
+        }
+
+      for (; i < n; ++i) {
+        if constexpr (Min)
+          lo = std::min(lo, data[i]);
+        if constexpr (Max)
+          hi = std::max(hi, data[i]);
+      }
+
+      return {lo, hi};
+    }
+
+    /**
+     * @brief Reduce the chunks of the range [0, size) in parallel
+     *
+     * The result of "reduce(begin, end)" for each chunk is stored in order
+     * in the returned vector, with the identity for the chunks not used by
+     * the thread pool.
+     */
+    template <class Policy, class T, class Reduce>
+    inline std::vector<T> _f_reduce_chunks(Policy const &policy, size_t size,
+                                           T identity, Reduce reduce) {
+
+      size_t const chunks = _f_number_of_chunks(policy, size);
+
+      std::vector<T> partial(chunks, identity);
+
+      _f_parallel_chunks(size, chunks, [&](size_t c, size_t b, size_t e) {
+        partial[c] = reduce(b, e);
+      });
+
+      return partial;
+    }
+
+    /// Pointer to the (constant) values of a column, and their type
+    template <class Column>
+    using column_value_t =
+        std::remove_const_t<std::remove_pointer_t<decltype(_f_column_data(
+            std::declval<Column const &>()))>>;
+
+    /// Sum of the selected fields of the elements of a container
+    template <size_t... I, class Policy, class Strategy, class Container>
+    inline auto _f_sum_of(Policy const &policy, Strategy strategy,
+                          Container const &container) {
+
+      field_value_t<typename Container::value_type, I...> result{};
+
+      size_t const size = container.size();
+
+      _f_for_each_column(
+          [&](auto &out, auto const &column) {
+            using type = column_value_t<std::decay_t<decltype(column)>>;
+
+            auto const data = _f_column_data(column);
+
+            auto const partial = _f_reduce_chunks(
+                policy, size, type(0), [&](size_t b, size_t e) {
+                  return _f_sum(strategy, data + b, e - b);
+                });
+
+            out = _f_sum(strategy, partial.data(), partial.size());
+          },
+          result, _f_select_columns<I...>(_f_columns(container)));
+
+      return result;
+    }
+
+    /// Minimum and maximum of the selected fields of the elements of a
+    /// container, computing only those requested
+    template <bool Min, bool Max, size_t... I, class Policy, class Container>
+    inline auto _f_extrema_of(Policy const &policy,
+                              Container const &container) {
+
+      using result_type = field_value_t<typename Container::value_type, I...>;
+
+      std::pair<result_type, result_type> result;
+
+      size_t const size = container.size();
+
+      _f_for_each_column(
+          [&](auto &lo, auto &hi, auto const &column) {
+            using type = column_value_t<std::decay_t<decltype(column)>>;
+
+            auto const data = _f_column_data(column);
+
+            auto const partial = _f_reduce_chunks(
+                policy, size,
+                std::make_pair(_f_highest_value<type>(),
+                               _f_lowest_value<type>()),
+                [&](size_t b, size_t e) {
+                  return _f_extrema<Min, Max>(data + b, e - b);
+                });
+
+            lo = _f_highest_value<type>();
+            hi = _f_lowest_value<type>();
+            for (auto const &p : partial) {
+              lo = std::min(lo, p.first);
+              hi = std::max(hi, p.second);
+            }
+          },
+          result.first, result.second,
+          _f_select_columns<I...>(_f_columns(container)));
+
+      return result;
+    }
+
+    /// Mean and variance of the selected fields of the elements of a
+    /// container, computed in two passes
+    template <size_t... I, class Policy, class Container>
+    inline auto _f_mean_var_of(Policy const &policy,
+                               Container const &container) {
+
+      using result_type =
+          moment_t<field_value_t<typename Container::value_type, I...>>;
+
+      std::pair<result_type, result_type> result{};
+
+      size_t const size = container.size();
+
+      _f_for_each_column(
+          [&](auto &mean, auto &var, auto const &column) {
+            using type = column_value_t<std::decay_t<decltype(column)>>;
+            using moment_type = moment_t<type>;
+
+            auto const data = _f_column_data(column);
+
+            auto moment = [&](auto t) {
+              auto const partial = _f_reduce_chunks(
+                  policy, size, moment_type(0), [&](size_t b, size_t e) {
+                    return _f_moment_sum(data + b, e - b, t);
+                  });
+              return _f_sum(summation::pairwise, partial.data(),
+                            partial.size()) /
+                     moment_type(size);
+            };
+
+            moment_type const mu = moment([](auto const &x) { return x; });
+
+            mean = mu;
+            var = moment([mu](auto const &x) {
+              auto const d = x - mu;
+              return d * d;
+            });
+          },
+          result.first, result.second,
+          _f_select_columns<I...>(_f_columns(container)));
+
+      return result;
+    }
+  } // namespace core
+
+  /**
+   * @brief Sum of the values of the elements of a container
+   *
+   * If field positions are given, the sum is that of the selected field,
+   * which can be a nested data object (e.g. smit::sum<0, 1>(v) adds the Y
+   * coordinates of the first field of the elements). Otherwise, the result
+   * is a value with the sum of each field of the elements. Each column is
+   * added with several SIMD accumulators, so containers must store the
+   * columns contiguously (smit::vector, smit::array and smit::mmap_vector).
+   * Values are added in their own type, and floating point values can be
+   * added with the more precise algorithms in smit::summation. With a
+   * parallel policy, each chunk of the container is added by a different
+   * thread, and the partial sums are added in order, so the result does not
+   * depend on the scheduling of the threads.
+   *
+   * @code
+   * auto const s = smit::sum(smit::execution::par, points);
+   * auto const x = smit::sum<0>(points, smit::summation::kahan);
+   * @endcode
+   */
+  template <size_t... I, class Policy, class Container,
+            class Strategy = summation::simple_strategy,
+            class = std::enable_if_t<execution::is_execution_policy_v<Policy> &&
+                                     summation::is_strategy_v<Strategy>>>
+  auto sum(Policy &&policy, Container const &container,
+           Strategy strategy = {}) {
+    return core::_f_sum_of<I...>(policy, strategy, container);
+  }
+
+  /// Sum of the values of the elements of a container, sequentially
+  template <size_t... I, class Container,
+            class Strategy = summation::simple_strategy,
+            class = std::enable_if_t<core::is_container<Container>::value &&
+                                     summation::is_strategy_v<Strategy>>>
+  auto sum(Container const &container, Strategy strategy = {}) {
+    return core::_f_sum_of<I...>(execution::seq, strategy, container);
+  }
+
+  /**
+   * @brief Minimum of the values of the elements of a container
+   *
+   * Fields are selected as in smit::sum. NaN values are ignored, and the
+   * result for empty containers is the largest value of the type (infinity
+   * for floating point types).
+   */
+  template <size_t... I, class Policy, class Container,
+            class = std::enable_if_t<execution::is_execution_policy_v<Policy>>>
+  auto min(Policy &&policy, Container const &container) {
+    return core::_f_extrema_of<true, false, I...>(policy, container).first;
+  }
+
+  /// Minimum of the values of the elements of a container, sequentially
+  template <size_t... I, class Container,
+            class = std::enable_if_t<core::is_container<Container>::value>>
+  auto min(Container const &container) {
+    return core::_f_extrema_of<true, false, I...>(execution::seq, container)
+        .first;
+  }
+
+  /**
+   * @brief Maximum of the values of the elements of a container
+   *
+   * Fields are selected as in smit::sum. NaN values are ignored, and the
+   * result for empty containers is the lowest value of the type (minus
+   * infinity for floating point types).
+   */
+  template <size_t... I, class Policy, class Container,
+            class = std::enable_if_t<execution::is_execution_policy_v<Policy>>>
+  auto max(Policy &&policy, Container const &container) {
+    return core::_f_extrema_of<false, true, I...>(policy, container).second;
+  }
+
+  /// Maximum of the values of the elements of a container, sequentially
+  template <size_t... I, class Container,
+            class = std::enable_if_t<core::is_container<Container>::value>>
+  auto max(Container const &container) {
+    return core::_f_extrema_of<false, true, I...>(execution::seq, container)
+        .second;
+  }
+
+  /**
+   * @brief Minimum and maximum of the values of the elements of a
+   * container, computed in a single pass
+   *
+   * @see smit::min
+   * @see smit::max
+   */
+  template <size_t... I, class Policy, class Container,
+            class = std::enable_if_t<execution::is_execution_policy_v<Policy>>>
+  auto minmax(Policy &&policy, Container const &container) {
+    return core::_f_extrema_of<true, true, I...>(policy, container);
+  }
+
+  /// Minimum and maximum of the values of the elements of a container,
+  /// sequentially
+  template <size_t... I, class Container,
+            class = std::enable_if_t<core::is_container<Container>::value>>
+  auto minmax(Container const &container) {
+    return core::_f_extrema_of<true, true, I...>(execution::seq, container);
+  }
+
+  /**
+   * @brief Mean and (population) variance of the values of the elements of
+   * a container
+   *
+   * Fields are selected as in smit::sum. The mean is computed first, and
+   * then the mean of the squared deviations from it, adding the values
+   * with pairwise summation, so there are no cancellations. Integral
+   * values are processed and returned in double precision, also for the
+   * fields of data objects (e.g. the centroid of a set of
+   * smit::point_3d<int> is a smit::point_3d<double>), so the results are
+   * always floating point values, which are NaN for empty containers.
+   */
+  template <size_t... I, class Policy, class Container,
+            class = std::enable_if_t<execution::is_execution_policy_v<Policy>>>
+  auto mean_var(Policy &&policy, Container const &container) {
+    return core::_f_mean_var_of<I...>(policy, container);
+  }
+
+  /// Mean and variance of the values of the elements of a container,
+  /// sequentially
+  template <size_t... I, class Container,
+            class = std::enable_if_t<core::is_container<Container>::value>>
+  auto mean_var(Container const &container) {
+    return core::_f_mean_var_of<I...>(execution::seq, container);
+  }
+} // namespace smit
+
+#endif // SMARTIT_REDUCTION_HPP
@@ -0,0 +1,732 @@
+#ifndef SMARTIT_SIMD_HPP
+#define SMARTIT_SIMD_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#include "memory.hpp"
+#include "traits.hpp"
+#include "utils.hpp"
+#include "value.hpp"
+
+namespace smit {
+
+  /**
+   * @brief Types and functions to operate on several elements at once
+   *
+   * Packs are built on top of the vector extensions of GCC and Clang, so
+   * operations on them are translated to SIMD instructions.
+   */
+  namespace simd {
+
+    /// Size (in bytes) of the native SIMD registers
+#if defined(__AVX512F__)
+    constexpr size_t native_size = 64;
+#elif defined(__AVX__)
+    constexpr size_t native_size = 32;
+#else
+    constexpr size_t native_size = 16;
+#endif
+
+    /// Number of lanes of the given type fitting in a native register
+    template <class T>
+    constexpr size_t native_width =
+        sizeof(T) < native_size ? native_size / sizeof(T) : 1;
+  } // namespace simd
+
+  namespace core {
+
+    /// Integer type with the given size
+    template <size_t N> struct integer_of_size {};
+    template <> struct integer_of_size<1> { using type = std::int8_t; };
+    template <> struct integer_of_size<2> { using type = std::int16_t; };
+    template <> struct integer_of_size<4> { using type = std::int32_t; };
+    template <> struct integer_of_size<8> { using type = std::int64_t; };
+
+    template <size_t N>
+    using integer_of_size_t = typename integer_of_size<N>::type;
+  } // namespace core
+
+  namespace simd {
+
+    /**
+     * @brief Result of a comparison between packs
+     *
+     * Each lane is either zero (false) or has all its bits set (true).
+     */
+    template <class T, size_t W> class mask {
+
+    public:
+      /// Type of the lanes
+      using integer_type = core::integer_of_size_t<sizeof(T)>;
+      /// Native vector type
+      typedef integer_type native_type
+          __attribute__((vector_size(sizeof(T) * W)));
+      /// Number of lanes
+      static constexpr size_t width = W;
+
+      /// Build a mask with all the lanes set to false
+      mask() : m_data{} {}
+      /// Build a mask with all the lanes set to the given value
+      mask(bool value) : m_data{native_type{} - integer_type(value)} {}
+      /// Build the mask from the native type
+      mask(native_type data) : m_data{data} {}
+
+      /// Mask with the first n lanes set to true
+      static mask first(size_t n) {
+        native_type index;
+        for (size_t i = 0; i < W; ++i)
+          index[i] = i;
+        return index < native_type{} + integer_type(n);
+      }
+
+      /// Value of the given lane
+      bool operator[](size_t i) const { return m_data[i] != 0; }
+
+      /// Access the native vector
+      native_type const &native() const { return m_data; }
+
+      /// Whether any of the lanes is set
+      bool any() const {
+        for (size_t i = 0; i < W; ++i)
+          if (m_data[i])
+            return true;
+        return false;
+      }
+
+      /// Whether all the lanes are set
+      bool all() const {
+        for (size_t i = 0; i < W; ++i)
+          if (!m_data[i])
+            return false;
+        return true;
+      }
+
+      /// Lanes set as the bits of an integer, the first lane being the
+      /// least significant bit
+      std::uint64_t bits() const {
+        static_assert(W <= 64, "Too many lanes to be stored as bits");
+        std::uint64_t b = 0;
+        for (size_t i = 0; i < W; ++i)
+          b |= std::uint64_t(m_data[i] != 0) << i;
+        return b;
+      }
+
+      /// Number of lanes set
+      size_t count() const {
+        size_t n = 0;
+        for (size_t i = 0; i < W; ++i)
+          n += (m_data[i] != 0);
+        return n;
+      }
+
+      friend mask operator&(mask const &a, mask const &b) {
+        return a.m_data & b.m_data;
+      }
+
+      friend mask operator|(mask const &a, mask const &b) {
+        return a.m_data | b.m_data;
+      }
+
+      friend mask operator^(mask const &a, mask const &b) {
+        return a.m_data ^ b.m_data;
+      }
+
+      friend mask operator!(mask const &a) { return ~a.m_data; }
+
+    protected:
+      /// Lanes of the mask
+      native_type m_data;
+    };
+
+    /**
+     * @brief Set of W values of the same arithmetic type
+     *
+     * Arithmetic operations are done lane by lane. Scalar values are
+     * broadcasted to all the lanes when combined with packs.
+     */
+    template <class T, size_t W> class pack {
+
+      static_assert(std::is_arithmetic<T>::value,
+                    "Packs can only be built from arithmetic types");
+      static_assert(W != 0 && (W & (W - 1)) == 0,
+                    "The number of lanes must be a power of two");
+
+    public:
+      /// Type of the lanes
+      using value_type = T;
+      /// Native vector type
+      typedef T native_type __attribute__((vector_size(sizeof(T) * W)));
+      /// Type of the result of the comparisons
+      using mask_type = mask<T, W>;
+      /// Number of lanes
+      static constexpr size_t width = W;
+
+      /// Build a pack with all the lanes set to zero
+      pack() : m_data{} {}
+      /// Build a pack with all the lanes set to the given value
+      pack(T value) : m_data{native_type{} + value} {}
+      /// Build the pack from the native type (a template, since the native
+      /// type can not be distinguished from T until instantiation)
+      template <class N, class = typename std::enable_if<
+                             !std::is_arithmetic<N>::value>::type>
+      pack(N const &data) : m_data{data} {}
+
+      /// Load W consecutive values
+      static pack load(T const *ptr) {
+        pack p;
+        std::memcpy(&p.m_data, ptr, sizeof(native_type));
+        return p;
+      }
+
+      /// Load n < W consecutive values, setting the rest of lanes to zero
+      static pack load(T const *ptr, size_t n) {
+        pack p;
+        std::memcpy(&p.m_data, ptr, n * sizeof(T));
+        return p;
+      }
+
+      /// Store the W values in consecutive positions
+      void store(T *ptr) const {
+        std::memcpy(ptr, &m_data, sizeof(native_type));
+      }
+
+      /// Store the first n < W values in consecutive positions
+      void store(T *ptr, size_t n) const {
+        std::memcpy(ptr, &m_data, n * sizeof(T));
+      }
+
+      /// Value of the given lane
+      T operator[](size_t i) const { return m_data[i]; }
+
+      /// Access the native vector
+      native_type const &native() const { return m_data; }
+
+      pack &operator+=(pack const &other) {
+        m_data += other.m_data;
+        return *this;
+      }
+
+      pack &operator-=(pack const &other) {
+        m_data -= other.m_data;
+        return *this;
+      }
+
+      pack &operator*=(pack const &other) {
+        m_data *= other.m_data;
+        return *this;
+      }
+
+      pack &operator/=(pack const &other) {
+        m_data /= other.m_data;
+        return *this;
+      }
+
+      pack operator-() const { return -m_data; }
+
+      friend pack operator+(pack const &a, pack const &b) {
+        return a.m_data + b.m_data;
+      }
+
+      friend pack operator-(pack const &a, pack const &b) {
+        return a.m_data - b.m_data;
+      }
+
+      friend pack operator*(pack const &a, pack const &b) {
+        return a.m_data * b.m_data;
+      }
+
+      friend pack operator/(pack const &a, pack const &b) {
+        return a.m_data / b.m_data;
+      }
+
+      friend mask_type operator<(pack const &a, pack const &b) {
+        return a.m_data < b.m_data;
+      }
+
+      friend mask_type operator<=(pack const &a, pack const &b) {
+        return a.m_data <= b.m_data;
+      }
+
+      friend mask_type operator>(pack const &a, pack const &b) {
+        return a.m_data > b.m_data;
+      }
+
+      friend mask_type operator>=(pack const &a, pack const &b) {
+        return a.m_data >= b.m_data;
+      }
+
+      friend mask_type operator==(pack const &a, pack const &b) {
+        return a.m_data == b.m_data;
+      }
+
+      friend mask_type operator!=(pack const &a, pack const &b) {
+        return a.m_data != b.m_data;
+      }
+
+    protected:
+      /// Lanes of the pack
+      native_type m_data;
+    };
+
+    /// Choose the lanes of "a" where the mask is set, and those of "b"
+    /// otherwise
+    template <class T, size_t W>
+    inline pack<T, W> select(mask<T, W> const &m, pack<T, W> const &a,
+                             pack<T, W> const &b) {
+      return m.native() ? a.native() : b.native();
+    }
+
+    /// Minimum of each lane
+    template <class T, size_t W>
+    inline pack<T, W> min(pack<T, W> const &a, pack<T, W> const &b) {
+      return select(b < a, b, a);
+    }
+
+    /// Maximum of each lane
+    template <class T, size_t W>
+    inline pack<T, W> max(pack<T, W> const &a, pack<T, W> const &b) {
+      return select(a < b, b, a);
+    }
+
+    /// Absolute value of each lane
+    template <class T, size_t W> inline pack<T, W> abs(pack<T, W> const &p) {
+      return select(p < T(0), -p, p);
+    }
+
+    /// Sum of all the lanes
+    template <class T, size_t W> inline T sum(pack<T, W> const &p) {
+      T s = p[0];
+      for (size_t i = 1; i < W; ++i)
+        s += p[i];
+      return s;
+    }
+
+    /// Square root of each lane
+    template <class T, size_t W> inline pack<T, W> sqrt(pack<T, W> const &p) {
+
+      T lanes[W];
+      std::memcpy(lanes, &p.native(), sizeof(lanes));
+
+      size_t i = 0;
+#if defined(__AVX__)
+      if constexpr (std::is_same<T, float>::value)
+        for (; i + 8 <= W; i += 8)
+          _mm256_storeu_ps(lanes + i,
+                           _mm256_sqrt_ps(_mm256_loadu_ps(lanes + i)));
+      else if constexpr (std::is_same<T, double>::value)
+        for (; i + 4 <= W; i += 4)
+          _mm256_storeu_pd(lanes + i,
+                           _mm256_sqrt_pd(_mm256_loadu_pd(lanes + i)));
+#endif
+#if defined(__SSE2__)
+      if constexpr (std::is_same<T, float>::value)
+        for (; i + 4 <= W; i += 4)
+          _mm_storeu_ps(lanes + i, _mm_sqrt_ps(_mm_loadu_ps(lanes + i)));
+      else if constexpr (std::is_same<T, double>::value)
+        for (; i + 2 <= W; i += 2)
+          _mm_storeu_pd(lanes + i, _mm_sqrt_pd(_mm_loadu_pd(lanes + i)));
+#endif
+      for (; i < W; ++i)
+        lanes[i] = std::sqrt(lanes[i]);
+
+      return pack<T, W>::load(lanes);
+    }
+  } // namespace simd
+
+  namespace core {
+
+    /**
+     * @brief Rational approximation of (asin(sqrt(z)) / sqrt(z) - 1) for
+     * z in [0, 0.25]
+     *
+     * Coefficients are taken from Cephes (single precision) and fdlibm
+     * (double precision).
+     */
+    template <class T, size_t W>
+    inline simd::pack<T, W> _f_asin_remainder(simd::pack<T, W> const &z) {
+      if constexpr (std::is_same<T, float>::value)
+        return z * ((((4.2163199048e-2f * z + 2.4181311049e-2f) * z +
+                      4.5470025998e-2f) *
+                         z +
+                     7.4953002686e-2f) *
+                        z +
+                    1.6666752422e-1f);
+      else {
+        auto const p =
+            z * (1.66666666666666657415e-01 +
+                 z * (-3.25565818622400915405e-01 +
+                      z * (2.01212532134862925881e-01 +
+                           z * (-4.00555345006794114027e-02 +
+                                z * (7.91534994289814532176e-04 +
+                                     z * 3.47933107596021167570e-05)))));
+        auto const q =
+            1. + z * (-2.40339491173441421878e+00 +
+                      z * (2.02094576023350569471e+00 +
+                           z * (-6.88283971605453293030e-01 +
+                                z * 7.70381505559019352791e-02)));
+        return p / q;
+      }
+    }
+  } // namespace core
+
+  namespace simd {
+
+    /// Arc cosine of each lane
+    template <class T, size_t W> inline pack<T, W> acos(pack<T, W> const &p) {
+
+      static_assert(std::is_same<T, float>::value ||
+                        std::is_same<T, double>::value,
+                    "The arc cosine is only defined for floating point packs");
+
+      T const pi = 3.14159265358979323846;
+
+      // for |x| <= 0.5, asin(x) = x + x R(x^2), otherwise
+      // acos(|x|) = 2 asin(sqrt((1 - |x|) / 2))
+      auto const a = abs(p);
+      auto const small = a <= T(0.5);
+      auto const z = select(small, p * p, (T(1) - a) * T(0.5));
+      auto const s = select(small, p, sqrt(z));
+      auto const r = s + s * core::_f_asin_remainder(z);
+
+      return select(small, T(0.5) * pi - r,
+                    select(p < T(0), pi - T(2) * r, T(2) * r));
+    }
+
+    /// Check whether a type is a pack
+    template <class T> struct is_pack : std::false_type {};
+
+    template <class T, size_t W>
+    struct is_pack<pack<T, W>> : std::true_type {};
+  } // namespace simd
+
+  namespace core {
+
+    /// Type used to store a field in a batch
+    template <class Type, size_t W, class Enable = void>
+    struct batch_field {}; // primary template
+
+    template <class Type, size_t W>
+    struct batch_field<
+        Type, W,
+        typename std::enable_if<std::is_arithmetic<Type>::value>::type> {
+      using type = simd::pack<Type, W>;
+    };
+
+    template <class Type, size_t W>
+    struct batch_field<
+        Type, W,
+        typename std::enable_if<!std::is_arithmetic<Type>::value &&
+                                !std::is_same<Type, __skipped_field>::value>::
+            type>;
+
+    /// Fields excluded from a projection are not loaded
+    template <class Type, size_t W>
+    struct batch_field<
+        Type, W,
+        typename std::enable_if<std::is_same<Type, __skipped_field>::value>::
+            type> {
+      using type = __skipped_field;
+    };
+
+    template <class Type, size_t W>
+    using batch_field_t = typename batch_field<Type, W>::type;
+
+    template <template <class> class Prototype, size_t W, class... Types>
+    constexpr auto _f_batch_type(utils::types_holder<Types...>) {
+      return utils::type_wrapper<
+          data_object<Prototype, batch_field_t<Types, W>...>>{};
+    }
+
+    template <class Type, size_t W>
+    struct batch_field<
+        Type, W,
+        typename std::enable_if<!std::is_arithmetic<Type>::value &&
+                                !std::is_same<Type, __skipped_field>::value>::
+            type> {
+      using type = typename decltype(
+          _f_batch_type<traits::extract_prototype<Type>::template type, W>(
+              typename Type::types{}))::type;
+    };
+
+    template <class... Types>
+    constexpr size_t _f_max_field_size_impl(utils::types_holder<Types...>);
+
+    /// Size of the largest arithmetic field of an object
+    template <class Type> constexpr size_t _f_max_field_size() {
+      if constexpr (std::is_arithmetic<Type>::value)
+        return sizeof(Type);
+      else if constexpr (std::is_same<Type, __skipped_field>::value)
+        return 1;
+      else
+        return _f_max_field_size_impl(typename Type::types{});
+    }
+
+    template <class... Types>
+    constexpr size_t _f_max_field_size_impl(utils::types_holder<Types...>) {
+      size_t s = 1;
+      ((s = _f_max_field_size<Types>() > s ? _f_max_field_size<Types>() : s),
+       ...);
+      return s;
+    }
+  } // namespace core
+
+  namespace simd {
+
+    /**
+     * @brief Data object storing W values per field
+     *
+     * Batches use the same prototype as the objects, so member and external
+     * functions defined for the prototype operate on W elements at once.
+     */
+    template <class Object, size_t W>
+    using batch = core::batch_field_t<Object, W>;
+
+    /// Default number of lanes for batches of the given object, so the
+    /// largest field fits in a native register
+    template <class Object>
+    constexpr size_t default_width =
+        core::_f_max_field_size<Object>() < native_size
+            ? native_size / core::_f_max_field_size<Object>()
+            : 1;
+  } // namespace simd
+
+  namespace core {
+
+    /// Maximum number of lanes of the batches loaded from a container. It is
+    /// the number of consecutive elements stored contiguously for each field,
+    /// unlimited unless the container is tiled.
+    template <class Container, class Enable = void>
+    struct max_batch_width
+        : std::integral_constant<size_t, std::numeric_limits<size_t>::max()> {
+    };
+
+    template <class Container>
+    struct max_batch_width<Container,
+                           std::void_t<decltype(Container::tile_width)>>
+        : std::integral_constant<size_t, Container::tile_width> {};
+
+    /// Alignment (in bytes) guaranteed for the first element of each column
+    /// of a container, which is that of the types unless it states a larger
+    /// one
+    template <class Container, class Enable = void>
+    struct column_alignment : std::integral_constant<size_t, 1> {};
+
+    template <class Container>
+    struct column_alignment<
+        Container, std::void_t<decltype(Container::column_alignment)>>
+        : std::integral_constant<size_t, Container::column_alignment> {};
+
+    /// Alignment of the values of a field of a batch loaded from columns
+    /// aligned to A bytes, at a position multiple of the number of lanes
+    template <size_t A, class Field> constexpr size_t _f_field_alignment() {
+      using type = typename Field::value_type;
+      return std::max(alignof(type), std::min(A, Field::width * sizeof(type)));
+    }
+
+    /// Number of lanes of the batches used to process objects of the given
+    /// type from some containers
+    template <class Object, class... Containers>
+    constexpr size_t batch_width =
+        std::min({simd::default_width<Object>,
+                  max_batch_width<std::decay_t<Containers>>::value...});
+
+    /// Access the columns of a nested container
+    template <class Container> inline auto &_f_columns(Container &container) {
+      using base_class =
+          typename std::remove_const<Container>::type::base_class;
+      if constexpr (std::is_const<Container>::value)
+        return static_cast<base_class const &>(container);
+      else
+        return static_cast<base_class &>(container);
+    }
+
+    template <size_t A = 1, class Batch, class Columns>
+    inline void _f_load_batch(Batch &batch, Columns &columns, size_t index,
+                              size_t n);
+
+    template <size_t A = 1, class Batch, class Columns>
+    inline void _f_store_batch(Batch const &batch, Columns &columns,
+                               size_t index, size_t n);
+
+    /// Load the values of a column in a field of a batch. If the columns
+    /// are aligned to A bytes, the position must be a multiple of the
+    /// number of lanes.
+    template <size_t A = 1, class Field, class Column>
+    inline void _f_load_field(Field &field, Column &column, size_t index,
+                              size_t n) {
+      if constexpr (simd::is_pack<Field>::value) {
+        auto const ptr =
+            _f_assume_aligned<_f_field_alignment<A, Field>()>(&column[index]);
+        field = (n == Field::width) ? Field::load(ptr) : Field::load(ptr, n);
+      } else if constexpr (!std::is_same<Field, __skipped_field>::value)
+        _f_load_batch<A>(field, _f_columns(column), index, n);
+    }
+
+    /// Store the values of a field of a batch in a column. If the columns
+    /// are aligned to A bytes, the position must be a multiple of the
+    /// number of lanes.
+    template <size_t A = 1, class Field, class Column>
+    inline void _f_store_field(Field const &field, Column &column,
+                               size_t index, size_t n) {
+      if constexpr (simd::is_pack<Field>::value) {
+        auto const ptr =
+            _f_assume_aligned<_f_field_alignment<A, Field>()>(&column[index]);
+        if (n == Field::width)
+          field.store(ptr);
+        else
+          field.store(ptr, n);
+      } else if constexpr (!std::is_same<Field, __skipped_field>::value)
+        _f_store_batch<A>(field, _f_columns(column), index, n);
+    }
+
+    template <size_t A, class Batch, class Columns, size_t... I>
+    inline void _f_load_batch_impl(Batch &batch, Columns &columns,
+                                   size_t index, size_t n,
+                                   std::index_sequence<I...>) {
+      (_f_load_field<A>(std::get<I>(batch), std::get<I>(columns), index, n),
+       ...);
+    }
+
+    template <size_t A, class Batch, class Columns, size_t... I>
+    inline void _f_store_batch_impl(Batch const &batch, Columns &columns,
+                                    size_t index, size_t n,
+                                    std::index_sequence<I...>) {
+      (_f_store_field<A>(std::get<I>(batch), std::get<I>(columns), index, n),
+       ...);
+    }
+
+    /// Load the elements in [index, index + n) of the columns in a batch
+    template <size_t A, class Batch, class Columns>
+    inline void _f_load_batch(Batch &batch, Columns &columns, size_t index,
+                              size_t n) {
+      _f_load_batch_impl<A>(
+          batch, columns, index, n,
+          std::make_index_sequence<Batch::number_of_fields>{});
+    }
+
+    /// Store the first n elements of a batch in [index, index + n) of the
+    /// columns
+    template <size_t A, class Batch, class Columns>
+    inline void _f_store_batch(Batch const &batch, Columns &columns,
+                               size_t index, size_t n) {
+      _f_store_batch_impl<A>(
+          batch, columns, index, n,
+          std::make_index_sequence<Batch::number_of_fields>{});
+    }
+
+    /// Call a function on a batch, passing the number of active lanes if
+    /// the function accepts it
+    template <class Function, class Batch>
+    inline void _f_call_batch(Function &f, Batch &batch, size_t n) {
+      if constexpr (std::is_invocable<Function &, Batch &, size_t>::value)
+        f(batch, n);
+      else
+        f(batch);
+    }
+
+    /**
+     * @brief Call a function on batches of W consecutive elements
+     *
+     * The last batch might be partially filled, in which case the inactive
+     * lanes are set to zero on load and ignored on store. If the columns are
+     * constant the batches are not stored back.
+     *
+     * Columns aligned to A bytes are accessed with aligned loads and
+     * stores. If the columns are padded, so W elements can be accessed
+     * after the last one, the last batch is loaded and stored as a whole,
+     * and its inactive lanes have unspecified values.
+     */
+    template <size_t W, class Object, size_t A = 1, bool Padded = false,
+              class Columns, class Function>
+    inline void _f_for_each_batch(Columns &columns, size_t size,
+                                  Function &f) {
+
+      using batch_type =
+          std::conditional_t<std::is_const<Columns>::value,
+                             simd::batch<Object, W> const,
+                             simd::batch<Object, W>>;
+
+      size_t i = 0;
+
+      for (; i + W <= size; i += W) {
+
+        simd::batch<Object, W> batch;
+
+        _f_load_batch<A>(batch, columns, i, W);
+        _f_call_batch(f, static_cast<batch_type &>(batch), W);
+
+        if constexpr (!std::is_const<Columns>::value)
+          _f_store_batch<A>(batch, columns, i, W);
+      }
+
+      if (i != size) {
+
+        simd::batch<Object, W> batch;
+
+        // padded columns avoid the partial copies
+        size_t const lanes = Padded ? W : size - i;
+
+        _f_load_batch<A>(batch, columns, i, lanes);
+        _f_call_batch(f, static_cast<batch_type &>(batch), size - i);
+
+        if constexpr (!std::is_const<Columns>::value)
+          _f_store_batch<A>(batch, columns, i, lanes);
+      }
+    }
+
+    /**
+     * @brief Call a function on batches of W consecutive elements in
+     * [first, last) of several containers
+     *
+     * The function receives the position of the first element, the number
+     * of active lanes and one batch per container. The batches are not
+     * stored back.
+     */
+    template <size_t W, class Function, class... Containers>
+    inline void _f_for_each_batch_in(size_t first, size_t last, Function &&f,
+                                     Containers const &... containers) {
+
+      auto call = [&](size_t index, size_t n) {
+        std::tuple<simd::batch<typename Containers::value_type, W>...>
+            batches;
+        std::apply(
+            [&](auto &... b) {
+              (_f_load_batch<column_alignment<Containers>::value>(
+                   b, _f_columns(containers), index, n),
+               ...);
+              f(index, n, b...);
+            },
+            batches);
+      };
+
+      size_t i = first;
+
+      for (; i + W <= last; i += W)
+        call(i, W);
+
+      if (i != last)
+        call(i, last - i);
+    }
+
+    /// Call a function on batches of W consecutive elements of several
+    /// containers with the same size (see smit::core::_f_for_each_batch_in)
+    template <size_t W, class Function, class... Containers>
+    inline void _f_for_each_batch_of(size_t size, Function &&f,
+                                     Containers const &... containers) {
+      _f_for_each_batch_in<W>(0, size, f, containers...);
+    }
+  } // namespace core
+} // namespace smit
+
+#endif // SMARTIT_SIMD_HPP
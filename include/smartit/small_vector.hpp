@@ -0,0 +1,426 @@
+#ifndef SMARTIT_SMALL_VECTOR_HPP
+#define SMARTIT_SMALL_VECTOR_HPP
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <tuple>
+
+#include "expression.hpp"
+#include "iterator.hpp"
+#include "layout.hpp"
+#include "memory.hpp"
+#include "simd.hpp"
+#include "vector.hpp"
+
+namespace smit {
+
+  /**
+   * @brief Vector storing up to N elements inside the object
+   *
+   * The columns are laid out as in smit::vector, but they are carved out of
+   * a buffer inside the object while the size does not exceed N, so small
+   * vectors do not allocate any memory. Once they grow beyond N elements,
+   * the columns are moved to a single memory block from the allocator, and
+   * they stay there until the vector is destroyed or assigned.
+   *
+   * Moving a vector whose elements are stored inside the object copies
+   * them, and invalidates the references and iterators of both vectors.
+   *
+   * @code
+   * smit::small_vector<smit::point_3d<float>, 32> hits;
+   * @endcode
+   *
+   * @see smit::vector
+   */
+  template <class Object, size_t N,
+            template <class> class Alloc = std::allocator>
+  class small_vector : public core::__vector_columns<Object> {
+
+    static_assert(N != 0, "The inline capacity can not be zero");
+
+  public:
+    /// Base class
+    using base_class = core::__vector_columns<Object>;
+    /// Layout policy of the container
+    using layout_type = layout::soa;
+    /// Alignment (in bytes) of the first element of each column
+    static constexpr size_t column_alignment = core::cache_line_size;
+    /// Number of elements stored inside the object
+    static constexpr size_t inline_capacity = N;
+    /// Allocator of the memory block
+    using allocator_type = Alloc<core::__cache_line>;
+    /// Type of the elements
+    using value_type = Object;
+    /// Vector iterator
+    using iterator = core::__iterator<base_class, Object>;
+    /// Vector constant iterator
+    using const_iterator = core::__const_iterator<base_class, Object>;
+    /// Type of the container returned on access
+    using reference = typename iterator::reference;
+    /// Type of the container returned on access (constant)
+    using const_reference = typename const_iterator::reference;
+    /// Type of the distance between iterators
+    using difference_type = typename iterator::difference_type;
+
+    /// Default constructor
+    small_vector() : base_class{} { this->use_inline_storage(); }
+    /// Construct the vector from a size
+    small_vector(size_t n) : base_class{} {
+      this->use_inline_storage();
+      this->resize(n);
+    }
+    /// Construct an empty vector using the given allocator
+    explicit small_vector(allocator_type const &allocator)
+        : base_class{}, m_allocator{allocator} {
+      this->use_inline_storage();
+    }
+    /// Construct the vector from a size, using the given allocator
+    small_vector(size_t n, allocator_type const &allocator)
+        : base_class{}, m_allocator{allocator} {
+      this->use_inline_storage();
+      this->resize(n);
+    }
+    /// Copy constructor
+    small_vector(small_vector const &other)
+        : base_class{}, m_allocator{allocator_traits::
+                                        select_on_container_copy_construction(
+                                            other.m_allocator)} {
+      this->use_inline_storage();
+      this->reserve(other.size());
+      this->copy_columns(other);
+      m_size = other.m_size;
+    }
+    /// Move constructor. The elements are copied if they are stored inside
+    /// the other vector.
+    small_vector(small_vector &&other)
+        : base_class{}, m_allocator{other.m_allocator} {
+      this->steal(other);
+    }
+    /// Construct the vector evaluating an expression
+    template <class Expression,
+              class = std::enable_if_t<core::is_expression<Expression>::value>>
+    small_vector(Expression const &expression) : base_class{} {
+      this->use_inline_storage();
+      *this = expression;
+    }
+    /// Destructor
+    ~small_vector() { this->deallocate(); }
+
+    /// Assignment operator
+    small_vector &operator=(small_vector other) {
+      this->steal(other);
+      return *this;
+    }
+
+    /// Evaluate an expression, storing the result in the vector. Elements
+    /// are only combined with those at the same position, so the vector can
+    /// be an operand of the expression.
+    template <class Expression,
+              class = std::enable_if_t<core::is_expression<Expression>::value>>
+    small_vector &operator=(Expression const &expression) {
+      this->resize(expression.size());
+      core::_f_evaluate<column_alignment>(
+          expression, static_cast<base_class &>(*this), m_size);
+      return *this;
+    }
+
+    inline reference operator[](size_t i) { return this->at(i); }
+
+    inline const_reference operator[](size_t i) const { return this->at(i); }
+
+    /// Returns a reference at position i in the vector
+    reference at(size_t i) {
+      return reference(static_cast<base_class &>(*this), i);
+    }
+
+    /// Returns a reference at position i in the vector (constant)
+    const_reference at(size_t i) const {
+      return const_reference(static_cast<base_class const &>(*this), i);
+    }
+
+    /// Test whether the vector is empty
+    inline bool empty() const { return this->size() == 0; }
+
+    /// Whether the elements are stored inside the object
+    inline bool is_inline() const { return m_block == nullptr; }
+
+    /// Requests that the vector capacity of each field be at least enough to
+    /// contain n elements.
+    void reserve(size_t n) {
+      if (n > m_capacity)
+        this->reallocate(n);
+    }
+
+    /// Change size
+    void resize(size_t n) {
+      this->grow(n);
+      if (n > m_size)
+        core::_f_for_each_column(
+            [this, n](auto &column) {
+              std::fill(column + m_size, column + n,
+                        std::remove_reference_t<decltype(*column)>{});
+            },
+            static_cast<base_class &>(*this));
+      m_size = n;
+    }
+
+    /// Add an element at the end of the vector, copying the fields of the
+    /// given value (or container type)
+    template <class T> void push_back(T const &obj) {
+
+      static_assert(T::number_of_fields == Object::number_of_fields,
+                    "The number of fields of the element does not match that "
+                    "of the vector");
+
+      if (m_size == m_capacity) {
+        // the argument might refer to an element of this vector, so its
+        // fields are copied before the memory is released
+        auto const value = core::_f_to_value(obj);
+        this->grow(m_size + 1);
+        core::_f_assign(this->at(m_size), value);
+      } else
+        core::_f_assign(this->at(m_size), obj);
+      ++m_size;
+    }
+
+    /// Add an element at the end of the vector, building each field from
+    /// one of the arguments
+    template <class... Args> reference emplace_back(Args &&... args) {
+
+      static_assert(sizeof...(Args) == Object::number_of_fields,
+                    "The number of arguments must match the number of fields");
+
+      if (m_size == m_capacity) {
+        // the arguments might refer to fields of this vector
+        auto values = std::make_tuple(core::_f_to_value(args)...);
+        this->grow(m_size + 1);
+        this->emplace_back_impl(
+            std::move(values),
+            std::make_index_sequence<Object::number_of_fields>{});
+      } else
+        this->emplace_back_impl(
+            std::forward_as_tuple(std::forward<Args>(args)...),
+            std::make_index_sequence<Object::number_of_fields>{});
+
+      return this->at(m_size++);
+    }
+
+    /// Get the size of the vector
+    inline size_t size() const { return m_size; }
+
+    /// Number of elements that can be held without reallocating
+    inline size_t capacity() const { return m_capacity; }
+
+    /// Allocator of the memory block
+    allocator_type get_allocator() const { return m_allocator; }
+
+    /// Swap the contents of two vectors. Elements stored inside the objects
+    /// are copied.
+    void swap(small_vector &other) {
+      small_vector tmp{std::move(other)};
+      other.steal(*this);
+      this->steal(tmp);
+    }
+
+    /// Call a function on batches of W consecutive elements. The function
+    /// receives a smit::simd::batch and, optionally, the number of active
+    /// lanes. The last batch is masked if the size is not a multiple of W.
+    template <size_t W = simd::default_width<Object>, class Function>
+    void for_each_batch(Function &&f) {
+      core::_f_for_each_batch<W, Object, column_alignment>(
+          static_cast<base_class &>(*this), m_size, f);
+    }
+
+    /// Call a function on batches of W consecutive elements (constant). The
+    /// batches are not stored back in the vector.
+    template <size_t W = simd::default_width<Object>, class Function>
+    void for_each_batch(Function &&f) const {
+      core::_f_for_each_batch<W, Object, column_alignment>(
+          static_cast<base_class const &>(*this), m_size, f);
+    }
+
+    /// Call a function on batches of W consecutive elements, accessing the
+    /// last batch as a whole, using the padding of the columns. The inactive
+    /// lanes of the last batch have unspecified values, and any value
+    /// stored in them is discarded.
+    template <size_t W = simd::default_width<Object>, class Function>
+    void for_each_padded_batch(Function &&f) {
+      static_assert(W * core::_f_max_field_size<Object>() <= column_alignment,
+                    "Batches can not be larger than the padding");
+      core::_f_for_each_batch<W, Object, column_alignment, true>(
+          static_cast<base_class &>(*this), m_size, f);
+    }
+
+    /// Call a function on batches of W consecutive elements, accessing the
+    /// last batch as a whole (constant). The batches are not stored back in
+    /// the vector.
+    template <size_t W = simd::default_width<Object>, class Function>
+    void for_each_padded_batch(Function &&f) const {
+      static_assert(W * core::_f_max_field_size<Object>() <= column_alignment,
+                    "Batches can not be larger than the padding");
+      core::_f_for_each_batch<W, Object, column_alignment, true>(
+          static_cast<base_class const &>(*this), m_size, f);
+    }
+
+    /// Pointer to the column of an arithmetic field, given by its position
+    /// and, for nested data objects, those of the fields inside them
+    template <size_t... I> auto data() {
+      return core::_f_assume_aligned<column_alignment>(
+          core::_f_column_data(core::_f_column<I...>(
+              static_cast<base_class &>(*this))));
+    }
+
+    /// Pointer to the column of an arithmetic field (constant)
+    template <size_t... I> auto data() const {
+      return core::_f_assume_aligned<column_alignment>(
+          core::_f_column_data(core::_f_column<I...>(
+              static_cast<base_class const &>(*this))));
+    }
+
+    /// Begining of the vector
+    iterator begin() { return {*this, 0}; }
+
+    /// Begining of the vector (constant)
+    const_iterator begin() const { return {*this, 0}; }
+
+    /// Begining of the vector (constant)
+    const_iterator cbegin() const { return {*this, 0}; }
+
+    /// End of the vector
+    iterator end() { return {*this, difference_type(m_size)}; }
+
+    /// End of the vector (constant)
+    const_iterator end() const { return {*this, difference_type(m_size)}; }
+
+    /// End of the vector (constant)
+    const_iterator cend() const { return {*this, difference_type(m_size)}; }
+
+  private:
+    /// Traits of the allocator
+    using allocator_traits = std::allocator_traits<allocator_type>;
+
+    /// Type of the field at the given position
+    template <size_t I>
+    using field_type = utils::tuple_element_for_t<I, typename Object::types>;
+
+    /// Allocator of the memory block
+    allocator_type m_allocator;
+    /// Memory block storing the arithmetic columns, if they do not fit in
+    /// the object
+    core::__cache_line *m_block = nullptr;
+    /// Number of elements
+    size_t m_size = 0;
+    /// Number of elements that fit in the storage in use
+    size_t m_capacity = 0;
+    /// Storage of the arithmetic columns inside the object
+    core::__cache_line m_inline[core::_f_column_lines<Object>(N)];
+
+    /// Make room for at least n elements, growing the capacity of all the
+    /// fields geometrically
+    inline void grow(size_t n) {
+      if (n > m_capacity)
+        this->reallocate(std::max(n, 2 * m_capacity));
+    }
+
+    /// Implementation of the emplace_back function
+    template <class Tuple, size_t... I>
+    inline void emplace_back_impl(Tuple &&args, std::index_sequence<I...>) {
+      (this->append_field<I>(std::get<I>(std::move(args))), ...);
+    }
+
+    /// Set the value of a field for the element after the last
+    template <size_t I, class T> inline void append_field(T &&value) {
+      if constexpr (std::is_arithmetic<field_type<I>>::value)
+        std::get<I>(*this)[m_size] = std::forward<T>(value);
+      else
+        core::_f_assign(std::get<I>(*this)[m_size], value);
+    }
+
+    /// Point the columns to a memory storage with the given capacity,
+    /// copying the elements
+    void place_columns(core::__cache_line *storage, size_t capacity) {
+      size_t offset = 0;
+      core::_f_for_each_column(
+          [this, storage, capacity, &offset](auto &column) {
+            using type = std::remove_reference_t<decltype(*column)>;
+            auto c = reinterpret_cast<type *>(storage + offset);
+            if (m_size != 0)
+              std::memcpy(c, column, m_size * sizeof(type));
+            column = c;
+            offset += core::_f_cache_lines<type>(capacity);
+          },
+          static_cast<base_class &>(*this));
+    }
+
+    /// Release the memory block, if any, and store the (no) elements inside
+    /// the object
+    void use_inline_storage() {
+      this->deallocate();
+      m_block = nullptr;
+      m_size = 0;
+      m_capacity = N;
+      this->place_columns(m_inline, N);
+    }
+
+    /// Copy the elements of another vector, which must fit in the capacity
+    void copy_columns(small_vector const &other) {
+      if (other.m_size != 0)
+        core::_f_for_each_column(
+            [&other](auto &column, auto const &other_column) {
+              std::memcpy(column, other_column,
+                          other.m_size * sizeof(*column));
+            },
+            static_cast<base_class &>(*this),
+            static_cast<base_class const &>(other));
+    }
+
+    /// Take the elements of another vector, leaving it empty. The memory
+    /// block is transferred, and the elements stored inside the object
+    /// copied.
+    void steal(small_vector &other) {
+
+      this->use_inline_storage();
+
+      m_allocator = other.m_allocator;
+
+      if (other.is_inline())
+        this->copy_columns(other);
+      else {
+        static_cast<base_class &>(*this) = static_cast<base_class &>(other);
+        m_block = other.m_block;
+        m_capacity = other.m_capacity;
+        other.m_block = nullptr;
+      }
+
+      m_size = other.m_size;
+
+      other.use_inline_storage();
+    }
+
+    /// Move the elements to a new memory block with the given capacity
+    void reallocate(size_t capacity) {
+
+      auto const lines = core::_f_column_lines<Object>(capacity);
+
+      core::__cache_line *block =
+          allocator_traits::allocate(m_allocator, lines);
+
+      this->place_columns(block, capacity);
+
+      this->deallocate();
+
+      m_block = block;
+      m_capacity = capacity;
+    }
+
+    /// Release the memory block
+    void deallocate() {
+      if (m_block != nullptr)
+        allocator_traits::deallocate(
+            m_allocator, m_block, core::_f_column_lines<Object>(m_capacity));
+    }
+  };
+} // namespace smit
+
+#endif // SMARTIT_SMALL_VECTOR_HPP
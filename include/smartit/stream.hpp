@@ -0,0 +1,411 @@
+#ifndef SMARTIT_STREAM_HPP
+#define SMARTIT_STREAM_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <limits>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+#include "format.hpp"
+#include "simd.hpp"
+#include "vector.hpp"
+
+namespace smit {
+
+  namespace core {
+
+    /**
+     * @brief Header of the streams written by smit::stream_writer
+     *
+     * The header is followed by the smit::core::__type_code of each
+     * arithmetic field of the object (nested data objects are flattened
+     * depth-first), and then by the chunks. Each chunk starts with a
+     * smit::core::__stream_chunk, followed by the values of its rows for
+     * each column, one column after the other. A chunk without rows marks
+     * the end of the stream. All the values are stored with the byte order
+     * of the platform that wrote the stream.
+     */
+    struct __stream_header {
+      /// Identifier of the format ("SMITSTRM")
+      char magic[8];
+      /// Version of the format
+      std::uint32_t version;
+      /// Must be smit::core::byte_order_mark when read
+      std::uint32_t byte_order;
+      /// Number of columns
+      std::uint64_t number_of_columns;
+    };
+
+    /// Header of a chunk in the streams written by smit::stream_writer
+    struct __stream_chunk {
+      /// Number of rows
+      std::uint64_t rows;
+      /// Size of the values of all the columns (in bytes)
+      std::uint64_t bytes;
+    };
+
+    /// Identifier of the streams written by smit::stream_writer
+    constexpr char stream_magic[8] = {'S', 'M', 'I', 'T', 'S', 'T', 'R', 'M'};
+
+    /// Version of the format of the streams written by smit::stream_writer
+    constexpr std::uint32_t stream_version = 1;
+
+    /// Default number of rows per chunk
+    constexpr size_t default_chunk_size = 1u << 16;
+
+    template <class... Types>
+    constexpr std::array<size_t, sizeof...(Types)>
+        _f_leaves_per_field(utils::types_holder<Types...>) {
+      return {number_of_leaves<Types>...};
+    }
+
+    /// Whether each column of an object belongs to the fields at positions
+    /// I... (nested data objects are selected as a whole)
+    template <class Object, size_t... I>
+    constexpr std::array<bool, number_of_leaves<Object>> _f_selected_columns() {
+
+      constexpr auto leaves = _f_leaves_per_field(typename Object::types{});
+
+      std::array<bool, number_of_leaves<Object>> selected{};
+
+      size_t k = 0;
+      for (size_t f = 0; f < leaves.size(); ++f)
+        for (size_t l = 0; l < leaves[f]; ++l)
+          selected[k++] = ((f == I) || ...);
+
+      return selected;
+    }
+
+    /// Size (in bytes) of a row of an object
+    template <class Object> constexpr size_t _f_row_bytes() {
+      size_t bytes = 0;
+      for (auto const &code : column_type_codes<Object>)
+        bytes += code.size;
+      return bytes;
+    }
+
+    /**
+     * @brief Call a function with the address and the number of the values
+     * of a column in [first, first + n) that are stored contiguously
+     *
+     * Columns of containers storing them contiguously are processed with a
+     * single call. Those of tiled containers are processed tile by tile,
+     * since the values of a field are only contiguous within a tile.
+     */
+    template <class Container, class Column, class Function>
+    inline void _f_for_each_run(Column &column, size_t first, size_t n,
+                                Function &&f) {
+      constexpr size_t width = max_batch_width<Container>::value;
+      if constexpr (width == std::numeric_limits<size_t>::max())
+        f(_f_column_data(column) + first, n);
+      else
+        for (size_t i = first, end = first + n; i < end;) {
+          size_t const m = std::min(width - i % width, end - i);
+          f(&column[i], m);
+          i += m;
+        }
+    }
+  } // namespace core
+
+  /**
+   * @brief Write the elements of containers to a binary stream in chunks
+   *
+   * The values of each chunk are written column by column, with a single
+   * call per column for containers storing the columns contiguously
+   * (smit::vector, smit::array and smit::mmap_vector), and a call per tile
+   * for smit::tiled_vector. Only sequential writes are done, so the stream
+   * can be a pipe. The end of the stream is marked on
+   * smit::stream_writer::close, or on destruction.
+   *
+   * Errors writing to the stream are reported with std::runtime_error.
+   *
+   * @see smit::stream_reader
+   * @see smit::core::__stream_header
+   */
+  template <class Object> class stream_writer {
+
+  public:
+    /// Write the header to the stream. Containers are written in chunks of
+    /// the given number of rows.
+    explicit stream_writer(std::ostream &stream,
+                           size_t chunk_size = core::default_chunk_size)
+        : m_stream{&stream}, m_chunk_size{std::max<size_t>(chunk_size, 1)} {
+
+      core::__stream_header header{};
+      std::memcpy(header.magic, core::stream_magic, sizeof(header.magic));
+      header.version = core::stream_version;
+      header.byte_order = core::byte_order_mark;
+      header.number_of_columns = type_codes.size();
+
+      this->write_bytes(&header, sizeof(header));
+      this->write_bytes(type_codes.data(), sizeof(type_codes));
+    }
+
+    stream_writer(stream_writer const &) = delete;
+    stream_writer &operator=(stream_writer const &) = delete;
+
+    /// Mark the end of the stream, if not done before
+    ~stream_writer() {
+      if (!m_closed && m_stream->good()) {
+        core::__stream_chunk end{};
+        m_stream->write(reinterpret_cast<char const *>(&end), sizeof(end));
+      }
+    }
+
+    /// Number of rows per chunk
+    size_t chunk_size() const { return m_chunk_size; }
+
+    /// Write all the elements of a container
+    template <class Container> void write(Container const &container) {
+      size_t const size = container.size();
+      for (size_t first = 0; first < size; first += m_chunk_size)
+        this->write_chunk(container, first,
+                          std::min(m_chunk_size, size - first));
+    }
+
+    /// Write the elements in [first, first + n) of a container as a single
+    /// chunk
+    template <class Container>
+    void write_chunk(Container const &container, size_t first, size_t n) {
+
+      static_assert(std::is_same<core::leaf_types_t<typename Container::
+                                                        value_type>,
+                                 core::leaf_types_t<Object>>::value,
+                    "The fields of the container do not match the object");
+
+      if (n == 0)
+        return;
+
+      core::__stream_chunk chunk{n, n * core::_f_row_bytes<Object>()};
+
+      this->write_bytes(&chunk, sizeof(chunk));
+
+      core::_f_for_each_column(
+          [this, first, n](auto const &column) {
+            core::_f_for_each_run<Container>(
+                column, first, n, [this](auto const *data, size_t m) {
+                  this->write_bytes(data, m * sizeof(*data));
+                });
+          },
+          core::_f_columns(container));
+    }
+
+    /// Mark the end of the stream and flush it. No more chunks can be
+    /// written after this call.
+    void close() {
+      if (m_closed)
+        return;
+      core::__stream_chunk end{};
+      this->write_bytes(&end, sizeof(end));
+      m_stream->flush();
+      m_closed = true;
+    }
+
+  private:
+    /// Codes of the types of the columns
+    static constexpr auto type_codes = core::column_type_codes<Object>;
+
+    /// Output stream
+    std::ostream *m_stream;
+    /// Number of rows per chunk
+    size_t m_chunk_size;
+    /// Whether the end of the stream has been written
+    bool m_closed = false;
+
+    /// Write a block of memory to the stream
+    void write_bytes(void const *data, size_t bytes) {
+      if (m_closed)
+        throw std::runtime_error("smit::stream_writer: stream closed");
+      if (!m_stream->write(static_cast<char const *>(data), bytes))
+        throw std::runtime_error("smit::stream_writer: unable to write");
+    }
+  };
+
+  /**
+   * @brief Read the elements written by smit::stream_writer
+   *
+   * Chunks are processed one at a time: smit::stream_reader::next reads the
+   * header of the following chunk, whose rows can then be read into a
+   * container, or skipped. Columns are read with a single call each (one
+   * per tile for smit::tiled_vector), and skipping only reads sequentially,
+   * so the stream can be a pipe.
+   *
+   * Streams that do not match the format or the fields of the object, or
+   * that end unexpectedly, are reported with std::runtime_error.
+   *
+   * @see smit::stream_writer
+   */
+  template <class Object> class stream_reader {
+
+  public:
+    /// Read the header of the stream, checking that it matches the object
+    explicit stream_reader(std::istream &stream) : m_stream{&stream} {
+
+      core::__stream_header header;
+      this->read_bytes(&header, sizeof(header));
+
+      if (std::memcmp(header.magic, core::stream_magic, sizeof(header.magic)))
+        error("invalid identifier");
+      if (header.version != core::stream_version)
+        error("unsupported version");
+      if (header.byte_order != core::byte_order_mark)
+        error("different byte order");
+      if (header.number_of_columns != type_codes.size())
+        error("wrong number of columns");
+
+      std::array<core::__type_code, type_codes.size()> codes;
+      this->read_bytes(codes.data(), sizeof(codes));
+
+      for (size_t k = 0; k < codes.size(); ++k)
+        if (codes[k] != type_codes[k])
+          error("wrong type of column " + std::to_string(k));
+    }
+
+    stream_reader(stream_reader const &) = delete;
+    stream_reader &operator=(stream_reader const &) = delete;
+
+    /**
+     * @brief Move to the next chunk, skipping the current one if it has not
+     * been read
+     *
+     * Returns false at the end of the stream.
+     */
+    bool next() {
+
+      if (m_pending)
+        this->skip();
+
+      if (m_end)
+        return false;
+
+      core::__stream_chunk chunk;
+      this->read_bytes(&chunk, sizeof(chunk));
+
+      if (chunk.rows == 0) {
+        m_end = true;
+        m_rows = 0;
+        return false;
+      }
+
+      if (chunk.bytes != chunk.rows * core::_f_row_bytes<Object>())
+        error("invalid size of chunk");
+
+      m_rows = chunk.rows;
+      m_pending = true;
+
+      return true;
+    }
+
+    /// Number of rows of the current chunk
+    size_t rows() const { return m_rows; }
+
+    /// Skip the rows of the current chunk
+    void skip() {
+      if (!m_pending)
+        return;
+      this->ignore_bytes(m_rows * core::_f_row_bytes<Object>());
+      m_pending = false;
+    }
+
+    /**
+     * @brief Read the rows of the current chunk into [index, index + rows())
+     * of a container
+     *
+     * If field positions are given, only those fields are read, and the
+     * rest are skipped.
+     */
+    template <size_t... I, class Container>
+    void read(Container &container, size_t index) {
+
+      static_assert(std::is_same<core::leaf_types_t<typename Container::
+                                                        value_type>,
+                                 core::leaf_types_t<Object>>::value,
+                    "The fields of the container do not match the object");
+
+      if (!m_pending)
+        throw std::logic_error("smit::stream_reader: no chunk to read");
+
+      if (index + m_rows > container.size())
+        throw std::out_of_range(
+            "smit::stream_reader: chunk does not fit in the container");
+
+      constexpr auto selected = selected_columns<I...>();
+
+      size_t k = 0;
+      core::_f_for_each_column(
+          [this, index, &k, &selected](auto &column) {
+            if (selected[k++])
+              core::_f_for_each_run<Container>(
+                  column, index, m_rows, [this](auto *data, size_t m) {
+                    this->read_bytes(data, m * sizeof(*data));
+                  });
+            else
+              this->ignore_bytes(m_rows * sizeof(column[index]));
+          },
+          core::_f_columns(container));
+
+      m_pending = false;
+    }
+
+    /// Append the rows of the current chunk to a container, resizing it
+    template <size_t... I, class Container> void append(Container &container) {
+      size_t const index = container.size();
+      container.resize(index + m_rows);
+      this->read<I...>(container, index);
+    }
+
+  private:
+    /// Codes of the types of the columns
+    static constexpr auto type_codes = core::column_type_codes<Object>;
+
+    /// Input stream
+    std::istream *m_stream;
+    /// Number of rows of the current chunk
+    size_t m_rows = 0;
+    /// Whether the rows of the current chunk have not been read
+    bool m_pending = false;
+    /// Whether the end of the stream has been reached
+    bool m_end = false;
+
+    /// Columns to read, all of them if no fields are selected
+    template <size_t... I> static constexpr auto selected_columns() {
+      if constexpr (sizeof...(I) == 0) {
+        std::array<bool, type_codes.size()> selected{};
+        for (auto &s : selected)
+          s = true;
+        return selected;
+      } else
+        return core::_f_selected_columns<Object, I...>();
+    }
+
+    /// Throw an exception reporting an invalid stream
+    [[noreturn]] static void error(std::string const &what) {
+      throw std::runtime_error("smit::stream_reader: " + what);
+    }
+
+    /// Read a block of memory from the stream
+    void read_bytes(void *data, size_t bytes) {
+      if (!m_stream->read(static_cast<char *>(data), bytes))
+        error("unexpected end of stream");
+    }
+
+    /// Discard a number of bytes from the stream
+    void ignore_bytes(size_t bytes) {
+      constexpr size_t step = std::numeric_limits<std::streamsize>::max();
+      while (bytes != 0) {
+        auto const n = std::min(bytes, step);
+        if (m_stream->ignore(n).gcount() != std::streamsize(n))
+          error("unexpected end of stream");
+        bytes -= n;
+      }
+    }
+  };
+} // namespace smit
+
+#endif // SMARTIT_STREAM_HPP
@@ -0,0 +1,315 @@
+#ifndef SMARTIT_THREAD_POOL_HPP
+#define SMARTIT_THREAD_POOL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include "memory.hpp"
+
+namespace smit {
+
+  namespace core {
+
+    /// Chunk boundaries are multiples of this number of elements, so the
+    /// threads do not write on the same cache lines of a column
+    constexpr size_t chunk_granularity = cache_line_size;
+
+    /// Number of elements per chunk when splitting [0, size) in "chunks"
+    /// pieces, rounded to the granularity
+    inline size_t _f_chunk_step(size_t size, size_t chunks) {
+      size_t const step = (size + chunks - 1) / chunks;
+      return (step + chunk_granularity - 1) / chunk_granularity *
+             chunk_granularity;
+    }
+  } // namespace core
+
+  /**
+   * @brief Pool of threads with work stealing
+   *
+   * Each worker owns a queue of tasks. Tasks submitted from a worker go to
+   * its own queue, and idle workers steal tasks from the others, so uneven
+   * work is balanced among the threads. The thread submitting a parallel
+   * loop processes chunks too while waiting for the rest, so loops can be
+   * nested (e.g. an outer loop over containers and an inner loop over the
+   * elements of each one) without blocking the pool.
+   *
+   * Exceptions thrown by the tasks of a loop are propagated to the thread
+   * that submitted it, once all the chunks have finished.
+   */
+  class thread_pool {
+
+  public:
+    /// Build the pool with the given number of workers. The thread
+    /// submitting the loops also processes chunks, so zero workers means
+    /// that everything runs in the calling thread.
+    explicit thread_pool(size_t workers) : m_queues(workers + 1) {
+
+      for (auto &q : m_queues)
+        q = std::make_unique<task_queue>();
+
+      m_threads.reserve(workers);
+      for (size_t i = 1; i <= workers; ++i)
+        m_threads.emplace_back([this, i]() { this->work(i); });
+    }
+
+    /// Build the pool with one worker per hardware thread, except the
+    /// calling thread
+    thread_pool()
+        : thread_pool(std::max<size_t>(std::thread::hardware_concurrency(),
+                                       1) -
+                      1) {}
+
+    thread_pool(thread_pool const &) = delete;
+    thread_pool &operator=(thread_pool const &) = delete;
+
+    /// Wait for the workers to finish
+    ~thread_pool() {
+      {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        m_stop = true;
+      }
+      m_condition.notify_all();
+      for (auto &t : m_threads)
+        t.join();
+    }
+
+    /// Pool shared by the parallel algorithms
+    static thread_pool &default_pool() {
+      static thread_pool pool;
+      return pool;
+    }
+
+    /// Number of workers
+    size_t size() const { return m_threads.size(); }
+
+    /**
+     * @brief Call a function on the chunks of the range [0, size)
+     *
+     * The function is called as f(chunk, begin, end). Chunk boundaries are
+     * multiples of smit::core::chunk_granularity. Returns once all the
+     * chunks have been processed.
+     */
+    template <class Function>
+    void parallel_chunks(size_t size, size_t chunks, Function &&f) {
+
+      if (chunks == 0 || size == 0)
+        return;
+
+      size_t const step = core::_f_chunk_step(size, chunks);
+
+      chunks = (size + step - 1) / step;
+
+      this->parallel_tasks(chunks, [&f, step, size](size_t c) {
+        f(c, c * step, std::min(size, (c + 1) * step));
+      });
+    }
+
+    /**
+     * @brief Call f(i) for each i in [0, n), each call being a separate
+     * task
+     *
+     * Unlike smit::thread_pool::parallel_chunks, the indices are not
+     * grouped, so a few calls with a lot of work each (e.g. merging pairs
+     * of sorted runs) are still spread among the threads. Returns once all
+     * the calls have finished.
+     */
+    template <class Function> void parallel_tasks(size_t n, Function &&f) {
+
+      if (n <= 1 || m_threads.empty()) {
+        for (size_t i = 0; i < n; ++i)
+          f(i);
+        return;
+      }
+
+      task_group group{n};
+
+      auto run = [&group, &f](size_t i) {
+        try {
+          f(i);
+        } catch (...) {
+          std::lock_guard<std::mutex> lock{group.mutex};
+          if (!group.exception)
+            group.exception = std::current_exception();
+        }
+        --group.remaining;
+      };
+
+      // the last tasks are submitted first, so those at the beginning of
+      // the range are processed first by the owner of the queue
+      for (size_t i = n - 1; i > 0; --i)
+        this->submit([&run, i]() { run(i); });
+
+      run(0);
+
+      while (group.remaining != 0)
+        if (!this->run_one())
+          std::this_thread::yield();
+
+      if (group.exception)
+        std::rethrow_exception(group.exception);
+    }
+
+    /// Call f(begin, end) on chunks of at least "grain" elements of the
+    /// range [0, size)
+    template <class Function>
+    void parallel_for(size_t size, size_t grain, Function &&f) {
+      this->parallel_chunks(
+          size, (size + grain - 1) / std::max<size_t>(grain, 1),
+          [&f](size_t, size_t begin, size_t end) { f(begin, end); });
+    }
+
+    /**
+     * @brief Reduce the range [0, size) in chunks of at least "grain"
+     * elements
+     *
+     * Each chunk is mapped to a partial result with map(begin, end). The
+     * partial results are reduced in the order of the chunks, and the
+     * chunks only depend on the size and the grain, so the result does not
+     * depend on the number of threads or on the scheduling.
+     */
+    template <class T, class Map, class Reduce>
+    T parallel_reduce(size_t size, size_t grain, T init, Map &&map,
+                      Reduce &&reduce) {
+
+      size_t const chunks = (size + grain - 1) / std::max<size_t>(grain, 1);
+
+      std::vector<std::optional<T>> partial(chunks);
+
+      this->parallel_chunks(size, chunks,
+                            [&](size_t c, size_t begin, size_t end) {
+                              partial[c] = map(begin, end);
+                            });
+
+      for (auto &p : partial)
+        if (p)
+          init = reduce(std::move(init), std::move(*p));
+
+      return init;
+    }
+
+  private:
+    /// Queue of tasks owned by a thread
+    struct task_queue {
+      std::mutex mutex;
+      std::deque<std::function<void()>> tasks;
+    };
+
+    /// Status of the chunks of a loop
+    struct task_group {
+      task_group(size_t chunks) : remaining{chunks} {}
+
+      std::atomic<size_t> remaining;
+      std::mutex mutex;
+      std::exception_ptr exception;
+    };
+
+    /// Index of the queue of the current thread in this pool (zero for
+    /// threads not belonging to the pool)
+    size_t queue_index() const {
+      return t_pool == this ? t_index : 0;
+    }
+
+    /// Add a task to the queue of the current thread
+    void submit(std::function<void()> task) {
+      {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        ++m_pending;
+      }
+      {
+        auto &q = *m_queues[this->queue_index()];
+        std::lock_guard<std::mutex> lock{q.mutex};
+        q.tasks.push_back(std::move(task));
+      }
+      m_condition.notify_one();
+    }
+
+    /// Run a task from the queue of the current thread or, if empty,
+    /// stolen from another queue. Returns false if no task was found.
+    bool run_one() {
+
+      size_t const self = this->queue_index();
+      size_t const n = m_queues.size();
+
+      std::function<void()> task;
+
+      for (size_t i = 0; i < n && !task; ++i) {
+
+        auto &q = *m_queues[(self + i) % n];
+
+        std::lock_guard<std::mutex> lock{q.mutex};
+
+        if (q.tasks.empty())
+          continue;
+
+        // the owner takes the newest task, thieves the oldest
+        if (i == 0) {
+          task = std::move(q.tasks.back());
+          q.tasks.pop_back();
+        } else {
+          task = std::move(q.tasks.front());
+          q.tasks.pop_front();
+        }
+      }
+
+      if (!task)
+        return false;
+
+      {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        --m_pending;
+      }
+
+      task();
+
+      return true;
+    }
+
+    /// Main loop of the workers
+    void work(size_t index) {
+
+      t_pool = this;
+      t_index = index;
+
+      while (true) {
+
+        if (this->run_one())
+          continue;
+
+        std::unique_lock<std::mutex> lock{m_mutex};
+        m_condition.wait(lock, [this]() { return m_stop || m_pending != 0; });
+
+        if (m_stop)
+          return;
+      }
+    }
+
+    /// Pool the current thread belongs to
+    static inline thread_local thread_pool const *t_pool = nullptr;
+    /// Index of the queue of the current thread
+    static inline thread_local size_t t_index = 0;
+
+    /// Queues of tasks (the first is shared by the external threads)
+    std::vector<std::unique_ptr<task_queue>> m_queues;
+    /// Workers
+    std::vector<std::thread> m_threads;
+    /// Protects the number of pending tasks and the stop flag
+    std::mutex m_mutex;
+    /// Notifies the workers of new tasks
+    std::condition_variable m_condition;
+    /// Number of tasks in the queues
+    size_t m_pending = 0;
+    /// Whether the workers must stop
+    bool m_stop = false;
+  };
+} // namespace smit
+
+#endif // SMARTIT_THREAD_POOL_HPP
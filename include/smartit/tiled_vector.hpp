@@ -0,0 +1,487 @@
+#ifndef SMARTIT_TILED_VECTOR_HPP
+#define SMARTIT_TILED_VECTOR_HPP
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+
+#include "expression.hpp"
+#include "iterator.hpp"
+#include "layout.hpp"
+#include "memory.hpp"
+#include "simd.hpp"
+
+namespace smit {
+
+  namespace core {
+
+    /**
+     * @brief Layout of a tile storing W elements of an object
+     *
+     * The W values of each arithmetic field (including those of the nested
+     * data objects) are stored contiguously, one field after the other.
+     * Each field is aligned to its size, and the size of the tile is a
+     * multiple of the size of the largest field.
+     */
+    template <size_t W, class... Leaves> struct __tile_layout {
+
+      static_assert(sizeof...(Leaves) != 0,
+                    "Tiles can not be built for objects without fields");
+      static_assert(W != 0 && (W & (W - 1)) == 0,
+                    "The number of elements in a tile must be a power of two");
+
+      /// Number of elements in a tile
+      static constexpr size_t width = W;
+
+      /// Round "n" to a multiple of "alignment"
+      static constexpr size_t align(size_t n, size_t alignment) {
+        return (n + alignment - 1) / alignment * alignment;
+      }
+
+      /// Offset (in bytes) of the values of the k-th field in the tile, or
+      /// of the end of the last field if k is the number of fields
+      static constexpr size_t offset(size_t k) {
+        constexpr size_t sizes[] = {sizeof(Leaves)...};
+        size_t o = 0;
+        for (size_t i = 0; i < k; ++i)
+          o = align(o, sizes[i]) + W * sizes[i];
+        return k < sizeof...(Leaves) ? align(o, sizes[k]) : o;
+      }
+
+      /// Size of the tile (in bytes)
+      static constexpr size_t bytes =
+          align(offset(sizeof...(Leaves)), std::max({sizeof(Leaves)...}));
+    };
+
+    template <size_t W, class... Leaves>
+    constexpr auto _f_tile_layout(utils::types_holder<Leaves...>) {
+      return utils::type_wrapper<__tile_layout<W, Leaves...>>{};
+    }
+
+    /// Layout of the tiles for the given object
+    template <class Object, size_t W>
+    using tile_layout_t = typename decltype(
+        _f_tile_layout<W>(leaf_types_t<Object>{}))::type;
+
+    /**
+     * @brief Column of an arithmetic field in a tiled container
+     *
+     * Holds the address of the values of the field in the first tile.
+     * Element "i" is found at lane (i % W) of tile (i / W).
+     */
+    template <class Type, class Layout> class __tiled_column {
+
+    public:
+      /// Build the column from the address in the first tile
+      __tiled_column(unsigned char *base = nullptr) : m_base{base} {}
+
+      /// Access the value of the given element
+      Type &operator[](size_t i) {
+        return *reinterpret_cast<Type *>(m_base + address(i));
+      }
+
+      /// Access the value of the given element (constant)
+      Type const &operator[](size_t i) const {
+        return *reinterpret_cast<Type const *>(m_base + address(i));
+      }
+
+    protected:
+      /// Address of an element with respect to the first tile
+      static constexpr size_t address(size_t i) {
+        return (i / Layout::width) * Layout::bytes +
+               (i % Layout::width) * sizeof(Type);
+      }
+
+      /// Address of the values of the field in the first tile
+      unsigned char *m_base;
+    };
+
+    template <class Object, class Layout, size_t FirstLeaf>
+    class __tiled_columns;
+
+    /// Type of the column of a field in a tiled container
+    template <class Type, class Layout, size_t Leaf, class Enable = void>
+    struct tiled_column {}; // primary template
+
+    template <class Type, class Layout, size_t Leaf>
+    struct tiled_column<
+        Type, Layout, Leaf,
+        typename std::enable_if<std::is_arithmetic<Type>::value>::type> {
+      using type = __tiled_column<Type, Layout>;
+    };
+
+    template <class Type, class Layout, size_t Leaf>
+    struct tiled_column<
+        Type, Layout, Leaf,
+        typename std::enable_if<!std::is_arithmetic<Type>::value>::type> {
+      using type = __tiled_columns<Type, Layout, Leaf>;
+    };
+
+    /// Number of arithmetic fields before the i-th field of an object
+    template <class... Types>
+    constexpr size_t _f_leaves_before(utils::types_holder<Types...>,
+                                      size_t i) {
+      constexpr size_t leaves[] = {number_of_leaves<Types>...};
+      size_t n = 0;
+      for (size_t j = 0; j < i; ++j)
+        n += leaves[j];
+      return n;
+    }
+
+    template <class Layout, size_t FirstLeaf, class... Types, size_t... I>
+    constexpr auto _f_tiled_columns_base(utils::types_holder<Types...>,
+                                         std::index_sequence<I...>) {
+      return utils::type_wrapper<
+          std::tuple<typename tiled_column<
+              Types, Layout,
+              FirstLeaf + _f_leaves_before(utils::types_holder<Types...>{},
+                                           I)>::type...>>{};
+    }
+
+    /// Tuple of the columns of the fields of an object in a tiled container
+    template <class Object, class Layout, size_t FirstLeaf>
+    using tiled_columns_base_t =
+        typename decltype(_f_tiled_columns_base<Layout, FirstLeaf>(
+            typename Object::types{},
+            std::make_index_sequence<Object::number_of_fields>{}))::type;
+
+    /**
+     * @brief Columns of the fields of an object in a tiled container
+     *
+     * The columns of the nested data objects are also of this type, so
+     * accessing one of their elements returns the container type of the
+     * nested object.
+     */
+    template <class Object, class Layout, size_t FirstLeaf>
+    class __tiled_columns
+        : public tiled_columns_base_t<Object, Layout, FirstLeaf> {
+
+    public:
+      /// Tuple of columns
+      using base_class = tiled_columns_base_t<Object, Layout, FirstLeaf>;
+      /// Type of the container returned on access
+      using reference =
+          __container_type<traits::extract_prototype<Object>::template type,
+                           false, typename Object::types>;
+      /// Type of the container returned on access (constant)
+      using const_reference =
+          __container_type<traits::extract_prototype<Object>::template type,
+                           true, typename Object::types>;
+
+      /// Number of consecutive elements stored contiguously for each field
+      static constexpr size_t tile_width = Layout::width;
+
+      /// Access the given element
+      reference operator[](size_t i) { return reference(*this, i); }
+
+      /// Access the given element (constant)
+      const_reference operator[](size_t i) const {
+        return const_reference(*this, i);
+      }
+
+      /// Point the columns to the values in the given block of tiles
+      void assign(unsigned char *block) {
+        this->assign_impl(
+            block, std::make_index_sequence<Object::number_of_fields>{});
+      }
+
+    private:
+      /// Implementation of the assign function
+      template <size_t... I>
+      inline void assign_impl(unsigned char *block,
+                              std::index_sequence<I...>) {
+        (this->assign_field<I>(block), ...);
+      }
+
+      /// Point the column of a field to the given block of tiles
+      template <size_t I> inline void assign_field(unsigned char *block) {
+
+        using field_type =
+            utils::tuple_element_for_t<I, typename Object::types>;
+
+        constexpr auto leaf =
+            FirstLeaf + _f_leaves_before(typename Object::types{}, I);
+
+        if constexpr (std::is_arithmetic<field_type>::value)
+          std::get<I>(*this) =
+              __tiled_column<field_type, Layout>(block + Layout::offset(leaf));
+        else
+          std::get<I>(*this).assign(block);
+      }
+    };
+  } // namespace core
+
+  /**
+   * @brief Vector storing the elements in tiles (array of structs of arrays)
+   *
+   * Each tile holds W consecutive elements, storing the values of each
+   * arithmetic field (including those of nested data objects) contiguously.
+   * Kernels accessing all the fields of an element read a single stream of
+   * memory, while batches of up to W elements can still be loaded in SIMD
+   * registers. Elements are accessed through the same container types as in
+   * smit::vector, so the functions defined for the prototypes work with both
+   * containers.
+   */
+  template <class Object, size_t W = 8,
+            template <class> class Alloc = std::allocator>
+  class tiled_vector
+      : public core::__tiled_columns<Object, core::tile_layout_t<Object, W>,
+                                     0> {
+
+  public:
+    /// Layout policy of the container
+    using layout_type = layout::aosoa<W>;
+    /// Layout of the tiles
+    using tile_layout = core::tile_layout_t<Object, W>;
+    /// Base class
+    using base_class = core::__tiled_columns<Object, tile_layout, 0>;
+    /// Type of the elements
+    using value_type = Object;
+    /// Allocator of the memory block
+    using allocator_type = Alloc<core::__cache_line>;
+    /// Vector iterator
+    using iterator = core::__iterator<base_class, Object>;
+    /// Vector constant iterator
+    using const_iterator = core::__const_iterator<base_class, Object>;
+    /// Type of the container returned on access
+    using reference = typename iterator::reference;
+    /// Type of the container returned on access (constant)
+    using const_reference = typename const_iterator::reference;
+    /// Type of the distance between iterators
+    using difference_type = typename iterator::difference_type;
+
+    /// Default constructor
+    tiled_vector() : base_class{} {}
+    /// Construct the vector from a size
+    tiled_vector(size_t n) : base_class{} { this->resize(n); }
+    /// Construct an empty vector using the given allocator
+    explicit tiled_vector(allocator_type const &allocator)
+        : base_class{}, m_allocator{allocator} {}
+    /// Construct the vector from a size, using the given allocator
+    tiled_vector(size_t n, allocator_type const &allocator)
+        : base_class{}, m_allocator{allocator} {
+      this->resize(n);
+    }
+    /// Copy constructor
+    tiled_vector(tiled_vector const &other)
+        : base_class{}, m_allocator{allocator_traits::
+                                        select_on_container_copy_construction(
+                                            other.m_allocator)} {
+      this->reserve(other.size());
+      if (other.m_size != 0)
+        std::memcpy(m_block, other.m_block,
+                    number_of_tiles(other.m_size) * tile_layout::bytes);
+      m_size = other.m_size;
+    }
+    /// Move constructor
+    tiled_vector(tiled_vector &&other)
+        : base_class{}, m_allocator{other.m_allocator} {
+      this->swap(other);
+    }
+    /// Construct the vector evaluating an expression
+    template <class Expression,
+              class = std::enable_if_t<core::is_expression<Expression>::value>>
+    tiled_vector(Expression const &expression) : base_class{} {
+      *this = expression;
+    }
+    /// Destructor
+    ~tiled_vector() { this->deallocate(); }
+
+    /// Assignment operator
+    tiled_vector &operator=(tiled_vector other) {
+      this->swap(other);
+      return *this;
+    }
+
+    /// Evaluate an expression, storing the result in the vector
+    template <class Expression,
+              class = std::enable_if_t<core::is_expression<Expression>::value>>
+    tiled_vector &operator=(Expression const &expression) {
+      this->resize(expression.size());
+      core::_f_evaluate(expression, static_cast<base_class &>(*this), m_size);
+      return *this;
+    }
+
+    inline reference operator[](size_t i) { return this->at(i); }
+
+    inline const_reference operator[](size_t i) const { return this->at(i); }
+
+    /// Returns a reference at position i in the vector
+    reference at(size_t i) {
+      return reference(static_cast<base_class &>(*this), i);
+    }
+
+    /// Returns a reference at position i in the vector (constant)
+    const_reference at(size_t i) const {
+      return const_reference(static_cast<base_class const &>(*this), i);
+    }
+
+    /// Test whether the vector is empty
+    inline bool empty() const { return this->size() == 0; }
+
+    /// Requests that the capacity be at least enough to contain n elements
+    void reserve(size_t n) {
+      if (n > m_capacity)
+        this->reallocate(n);
+    }
+
+    /// Change size
+    void resize(size_t n) {
+      this->grow(n);
+      for (size_t i = m_size; i < n; ++i)
+        core::_f_assign(this->at(i), Object{});
+      m_size = n;
+    }
+
+    /// Add an element at the end of the vector, copying the fields of the
+    /// given value (or container type)
+    template <class T> void push_back(T const &obj) {
+
+      static_assert(T::number_of_fields == Object::number_of_fields,
+                    "The number of fields of the element does not match that "
+                    "of the vector");
+
+      if (m_size == m_capacity) {
+        // the argument might refer to an element of this vector, so its
+        // fields are copied before the tiles are released
+        auto const value = core::_f_to_value(obj);
+        this->grow(m_size + 1);
+        core::_f_assign(this->at(m_size), value);
+      } else
+        core::_f_assign(this->at(m_size), obj);
+      ++m_size;
+    }
+
+    /// Add an element at the end of the vector, building each field from
+    /// one of the arguments
+    template <class... Args> reference emplace_back(Args &&... args) {
+
+      static_assert(sizeof...(Args) == Object::number_of_fields,
+                    "The number of arguments must match the number of fields");
+
+      this->push_back(Object(std::forward<Args>(args)...));
+
+      return this->at(m_size - 1);
+    }
+
+    /// Get the size of the vector
+    inline size_t size() const { return m_size; }
+
+    /// Number of elements that can be held without reallocating
+    inline size_t capacity() const { return m_capacity; }
+
+    /// Allocator of the memory block
+    allocator_type get_allocator() const { return m_allocator; }
+
+    /// Swap the contents of two vectors
+    void swap(tiled_vector &other) {
+      std::swap(static_cast<base_class &>(*this),
+                static_cast<base_class &>(other));
+      std::swap(m_allocator, other.m_allocator);
+      std::swap(m_block, other.m_block);
+      std::swap(m_size, other.m_size);
+      std::swap(m_capacity, other.m_capacity);
+    }
+
+    /// Call a function on batches of B consecutive elements. The number of
+    /// lanes must divide the number of elements in a tile.
+    template <size_t B = core::batch_width<Object, base_class>,
+              class Function>
+    void for_each_batch(Function &&f) {
+      static_assert(W % B == 0, "Batches can not span several tiles");
+      core::_f_for_each_batch<B, Object>(static_cast<base_class &>(*this),
+                                         m_size, f);
+    }
+
+    /// Call a function on batches of B consecutive elements (constant). The
+    /// batches are not stored back in the vector.
+    template <size_t B = core::batch_width<Object, base_class>,
+              class Function>
+    void for_each_batch(Function &&f) const {
+      static_assert(W % B == 0, "Batches can not span several tiles");
+      core::_f_for_each_batch<B, Object>(
+          static_cast<base_class const &>(*this), m_size, f);
+    }
+
+    /// Begining of the vector
+    iterator begin() { return {*this, 0}; }
+
+    /// Begining of the vector (constant)
+    const_iterator begin() const { return {*this, 0}; }
+
+    /// Begining of the vector (constant)
+    const_iterator cbegin() const { return {*this, 0}; }
+
+    /// End of the vector
+    iterator end() { return {*this, difference_type(m_size)}; }
+
+    /// End of the vector (constant)
+    const_iterator end() const { return {*this, difference_type(m_size)}; }
+
+    /// End of the vector (constant)
+    const_iterator cend() const { return {*this, difference_type(m_size)}; }
+
+  private:
+    /// Traits of the allocator
+    using allocator_traits = std::allocator_traits<allocator_type>;
+
+    /// Allocator of the memory block
+    allocator_type m_allocator;
+    /// Memory block storing the tiles
+    core::__cache_line *m_block = nullptr;
+    /// Number of elements
+    size_t m_size = 0;
+    /// Number of elements that fit in the memory block
+    size_t m_capacity = 0;
+
+    /// Number of tiles needed to store n elements
+    static constexpr size_t number_of_tiles(size_t n) {
+      return (n + W - 1) / W;
+    }
+
+    /// Number of cache lines needed to store the tiles
+    static constexpr size_t block_lines(size_t capacity) {
+      return core::_f_cache_lines<unsigned char>(number_of_tiles(capacity) *
+                                                 tile_layout::bytes);
+    }
+
+    /// Make room for at least n elements, growing the capacity
+    /// geometrically
+    inline void grow(size_t n) {
+      if (n > m_capacity)
+        this->reallocate(std::max(n, 2 * m_capacity));
+    }
+
+    /// Move the tiles to a new memory block with the given capacity
+    void reallocate(size_t capacity) {
+
+      capacity = number_of_tiles(capacity) * W;
+
+      auto const lines = block_lines(capacity);
+
+      core::__cache_line *block =
+          lines != 0 ? allocator_traits::allocate(m_allocator, lines)
+                     : nullptr;
+
+      if (m_size != 0)
+        std::memcpy(block, m_block,
+                    number_of_tiles(m_size) * tile_layout::bytes);
+
+      this->deallocate();
+
+      m_block = block;
+      m_capacity = capacity;
+
+      this->assign(reinterpret_cast<unsigned char *>(m_block));
+    }
+
+    /// Release the memory block
+    void deallocate() {
+      if (m_block != nullptr)
+        allocator_traits::deallocate(m_allocator, m_block,
+                                     block_lines(m_capacity));
+    }
+  };
+} // namespace smit
+
+#endif // SMARTIT_TILED_VECTOR_HPP
@@ -3,6 +3,7 @@
 
 #include <cmath>
 
+#include "expression.hpp"
 #include "value.hpp"
 
 namespace smit {
@@ -38,11 +39,17 @@ namespace smit {
 
     /// Angle with respect to the X axis
     auto phi() const {
-      return std::acos(x() / std::sqrt(x() * x() + y() * y()));
+      using std::acos;
+      using std::sqrt;
+      return acos(x() / sqrt(x() * x() + y() * y()));
     }
 
     /// Angle with respect to the Z axis
-    auto theta() const { return std::acos(z() / std::sqrt(mod2())); }
+    auto theta() const {
+      using std::acos;
+      using std::sqrt;
+      return acos(z() / sqrt(mod2()));
+    }
   };
 
   /**
@@ -61,7 +68,8 @@ namespace smit {
 
   /// Cross product
   template <class T1, class T2>
-  build_value_type_t<point_3d_proto, T1, T2> cross(const T1 &f, const T2 &s) {
+  build_value_type_t<point_3d_proto, point_3d_proto<T1>, point_3d_proto<T2>>
+  cross(point_3d_proto<T1> const &f, point_3d_proto<T2> const &s) {
     return {
         f.y() * s.z() - f.z() * s.y(),
         f.z() * s.x() - f.x() * s.z(),
@@ -69,6 +77,14 @@ namespace smit {
     };
   }
 
+  /// Cross product of the elements of containers or expressions (lazy)
+  template <class T1, class T2,
+            class = std::enable_if_t<core::is_lazy_operation<T1, T2>::value>>
+  auto cross(T1 const &f, T2 const &s) {
+    return make_expression(
+        [](auto const &a, auto const &b) { return cross(a, b); }, f, s);
+  }
+
   /**
    * @brief Prototype class for a point and a vector in three dimensions
    *
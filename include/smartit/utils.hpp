@@ -12,6 +12,24 @@ namespace smit {
     /// Hold types
     template <typename... Types> struct types_holder {};
 
+    /// Concatenate several smit::utils::types_holder objects
+    template <class... Holders> struct concat_types {
+      using type = types_holder<>;
+    };
+
+    template <class... Types> struct concat_types<types_holder<Types...>> {
+      using type = types_holder<Types...>;
+    };
+
+    template <class... First, class... Second, class... Rest>
+    struct concat_types<types_holder<First...>, types_holder<Second...>,
+                        Rest...>
+        : concat_types<types_holder<First..., Second...>, Rest...> {};
+
+    /// Type of smit::utils::concat_types
+    template <class... Holders>
+    using concat_types_t = typename concat_types<Holders...>::type;
+
     /// Hold templates
     template <template <class...> class T> struct template_holder {
       template <class... U> using type = T<U...>;
@@ -48,7 +66,7 @@ namespace smit {
     /// Access the type of an element of a dependent type
     template <size_t I, class Dependent> struct tuple_element_for {
       using type = typename decltype(
-          _f_tuple_element_for(types_holder<Dependent>{}))::type;
+          _f_tuple_element_for<I>(types_holder<Dependent>{}))::type;
     };
 
     /// Type of smit::utils::tuple_element_for
@@ -2,6 +2,8 @@
 #define SMARTIT_VALUE_HPP
 
 #include <tuple>
+#include <type_traits>
+#include <utility>
 
 #include "traits.hpp"
 #include "utils.hpp"
@@ -27,17 +29,22 @@ namespace smit {
 
     /**
      * @brief Base template for a container type
+     *
+     * Stores the references to the fields of an element of a container. The
+     * arithmetic fields are referred through pointers, and the nested data
+     * objects through their own container types.
      */
-    template <class... Iterators>
-    class __base_container_type : public std::tuple<Iterators &...> {
+    template <bool Const, class... Fields> class __base_container_type;
 
-    public:
-      using base_class = std::tuple<Iterators &...>;
-
-      /// Construct the class from the iterator instance
-      __base_container_type(std::tuple<Iterators...> &it)
-          : base_class{std::move(utils::vtuple_to_rtuple(it))} {}
-    };
+    /**
+     * @brief Placeholder for the fields excluded from a projection
+     *
+     * Functions of the prototype accessing these fields can not be used on
+     * the elements of the projection.
+     *
+     * @see smit::project
+     */
+    struct __skipped_field {};
   } // namespace core
 
   /**
@@ -110,16 +117,126 @@ namespace smit {
 
   namespace core {
 
-    template <template <class> class Prototype, class... Iterators>
-    constexpr auto _f_container_type(utils::types_holder<Iterators...>) {
-      return utils::type_wrapper<
-          Prototype<__base_container_type<Iterators...>>>{};
+    /**
+     * @brief Reference to an element of a container
+     *
+     * Wraps the container type, so assigning and swapping elements operates
+     * on the values of the fields instead of on the references.
+     */
+    template <class Container> class __proxy_reference;
+
+    template <template <class> class Prototype, bool Const, class... Fields>
+    constexpr auto _f_container_type(utils::types_holder<Fields...>) {
+      return utils::type_wrapper<__proxy_reference<
+          Prototype<__base_container_type<Const, Fields...>>>>{};
     }
 
     /// Declaration of the container type
-    template <template <class> class Prototype, class IterTypes>
-    using __container_type =
-        typename decltype(_f_container_type<Prototype>(IterTypes{}))::type;
+    template <template <class> class Prototype, bool Const, class H>
+    using __container_type = typename decltype(
+        _f_container_type<Prototype, Const>(H{}))::type;
+
+    /// Type used to refer to a field of an element in a container
+    template <class Type, bool Const, class Enable = void>
+    struct field_reference {}; // primary template
+
+    template <class Type, bool Const>
+    struct field_reference<
+        Type, Const,
+        typename std::enable_if<std::is_arithmetic<Type>::value>::type> {
+      using type = std::conditional_t<Const, Type const *, Type *>;
+    };
+
+    template <class Type, bool Const>
+    struct field_reference<
+        Type, Const,
+        typename std::enable_if<!std::is_arithmetic<Type>::value &&
+                                !std::is_same<Type, __skipped_field>::value>::
+            type> {
+      using type =
+          __container_type<traits::extract_prototype<Type>::template type,
+                           Const, typename Type::types>;
+    };
+
+    template <class Type, bool Const>
+    struct field_reference<
+        Type, Const,
+        typename std::enable_if<std::is_same<Type, __skipped_field>::value>::
+            type> {
+      using type = __skipped_field;
+    };
+
+    template <class Type, bool Const>
+    using field_reference_t = typename field_reference<Type, Const>::type;
+
+    /// Build the reference to the element of a column at the given position
+    template <class Reference, class Column>
+    inline Reference _f_make_reference(Column &column, size_t index) {
+      if constexpr (std::is_pointer<Reference>::value)
+        return &column[index];
+      else if constexpr (std::is_same<Reference, __skipped_field>::value)
+        return {};
+      else
+        return column[index];
+    }
+
+    /// Column of an arithmetic field, given by its position and, for nested
+    /// data objects, those of the fields inside them
+    template <size_t I, size_t... J, class Columns>
+    inline auto &_f_column(Columns &columns) {
+      if constexpr (sizeof...(J) == 0)
+        return std::get<I>(columns);
+      else
+        return _f_column<J...>(std::get<I>(columns));
+    }
+
+    /// Pointer to the first element of a column, to constant values if the
+    /// column is constant
+    template <class Column> inline auto _f_column_data(Column &column) {
+      using type = std::remove_const_t<Column>;
+      if constexpr (!std::is_pointer<type>::value)
+        return column.data();
+      else if constexpr (std::is_const<Column>::value)
+        return static_cast<std::remove_pointer_t<type> const *>(column);
+      else
+        return column;
+    }
+
+    /// Access the value referred by a field reference
+    template <class Reference> inline auto &_f_deref(Reference &reference) {
+      if constexpr (std::is_pointer<Reference>::value)
+        return *reference;
+      else
+        return reference;
+    }
+
+    template <bool Const, class... Fields>
+    class __base_container_type
+        : public std::tuple<field_reference_t<Fields, Const>...> {
+
+    public:
+      using base_class = std::tuple<field_reference_t<Fields, Const>...>;
+      using types = utils::types_holder<Fields...>;
+
+      static const auto number_of_fields = sizeof...(Fields);
+
+      /// Build the references to the elements of the columns at the given
+      /// position
+      template <class Columns>
+      __base_container_type(Columns &columns, size_t index)
+          : base_class{make_base(
+                columns, index,
+                std::make_index_sequence<sizeof...(Fields)>{})} {}
+
+    private:
+      /// Implementation of the constructor
+      template <class Columns, size_t... I>
+      static base_class make_base(Columns &columns, size_t index,
+                                  std::index_sequence<I...>) {
+        return {_f_make_reference<field_reference_t<Fields, Const>>(
+            std::get<I>(columns), index)...};
+      }
+    };
 
     template <template <class> class Prototype, class... Types>
     constexpr auto _f_value_type(utils::types_holder<Types...>) {
@@ -141,20 +258,17 @@ namespace smit {
     return std::get<I>(obj);
   }
 
-  /// Access a field of an object based on std::tuple
-  template <size_t I, class... Iterators>
-  inline typename std::iterator_traits<
-      utils::tuple_element_t<I, Iterators...>>::value_type &
-  get_field(core::__base_container_type<Iterators...> &obj) {
-    return *std::get<I>(obj);
+  /// Access a field of an element in a container
+  template <size_t I, bool Const, class... Fields>
+  inline auto &get_field(core::__base_container_type<Const, Fields...> &obj) {
+    return core::_f_deref(std::get<I>(obj));
   }
 
-  /// Access a field of an object based on std::tuple
-  template <size_t I, class... Iterators>
-  inline typename std::iterator_traits<
-      utils::tuple_element_t<I, Iterators...>>::value_type const &
-  get_field_const(core::__base_container_type<Iterators...> const &obj) {
-    return *std::get<I>(obj);
+  /// Access a field of an element in a container
+  template <size_t I, bool Const, class... Fields>
+  inline auto const &
+  get_field_const(core::__base_container_type<Const, Fields...> const &obj) {
+    return core::_f_deref(std::get<I>(obj));
   }
 
   /**
@@ -201,6 +315,160 @@ namespace smit {
   template <template <class> class Prototype, class First, class... Last>
   using build_value_type_t =
       typename build_value_type<Prototype, First, Last...>::type;
+
+  namespace core {
+
+    /// Check whether a type has fields (data objects, container types and
+    /// batches)
+    template <class T, class Enable = void>
+    struct has_fields : std::false_type {};
+
+    template <class T>
+    struct has_fields<T, std::void_t<typename T::types>> : std::true_type {};
+
+    /// Arithmetic types of the fields of an object, flattening the nested
+    /// data objects in depth-first order
+    template <class Type, class Enable = void> struct leaf_types {
+      using type = utils::types_holder<Type>;
+    };
+
+    template <class... Types>
+    constexpr auto _f_leaf_types(utils::types_holder<Types...>) {
+      return utils::type_wrapper<utils::concat_types_t<
+          typename leaf_types<Types>::type...>>{};
+    }
+
+    template <class Type>
+    struct leaf_types<
+        Type, typename std::enable_if<!std::is_arithmetic<Type>::value>::type> {
+      using type =
+          typename decltype(_f_leaf_types(typename Type::types{}))::type;
+    };
+
+    /// Type of smit::core::leaf_types
+    template <class Type> using leaf_types_t = typename leaf_types<Type>::type;
+
+    template <class... Types>
+    constexpr size_t _f_number_of_leaves(utils::types_holder<Types...>) {
+      return sizeof...(Types);
+    }
+
+    /// Number of arithmetic fields of an object, including those of the
+    /// nested data objects
+    template <class Type>
+    constexpr size_t number_of_leaves =
+        _f_number_of_leaves(leaf_types_t<Type>{});
+
+    template <class Reference, class Value, size_t... I>
+    inline void _f_assign_impl(Reference &reference, Value const &value,
+                               std::index_sequence<I...>);
+
+    /// Assign a value to a field or to an element of a container, field by
+    /// field
+    template <class Reference, class Value>
+    inline void _f_assign(Reference &&reference, Value const &value) {
+      using type = std::remove_reference_t<Reference>;
+      if constexpr (has_fields<type>::value)
+        _f_assign_impl(reference, value,
+                       std::make_index_sequence<type::number_of_fields>{});
+      else if constexpr (!std::is_same<type, __skipped_field>::value)
+        reference = value;
+    }
+
+    template <class Reference, class Value, size_t... I>
+    inline void _f_assign_impl(Reference &reference, Value const &value,
+                               std::index_sequence<I...>) {
+      (_f_assign(get_field<I>(reference), get_field_const<I>(value)), ...);
+    }
+
+    template <class Reference, size_t... I>
+    inline auto _f_to_value_impl(Reference const &reference,
+                                 std::index_sequence<I...>);
+
+    /// Copy the fields of an element of a container into a value
+    template <class Reference>
+    inline auto _f_to_value(Reference const &reference) {
+      if constexpr (has_fields<Reference>::value)
+        return _f_to_value_impl(
+            reference,
+            std::make_index_sequence<Reference::number_of_fields>{});
+      else
+        return reference;
+    }
+
+    template <class Reference, size_t... I>
+    inline auto _f_to_value_impl(Reference const &reference,
+                                 std::index_sequence<I...>) {
+      return extract_value_type_t<Reference>{
+          _f_to_value(get_field_const<I>(reference))...};
+    }
+
+    template <class Reference, size_t... I>
+    inline void _f_swap_impl(Reference &a, Reference &b,
+                             std::index_sequence<I...>);
+
+    /// Swap the values of two fields or elements of a container, field by
+    /// field
+    template <class Reference> inline void _f_swap(Reference &a, Reference &b) {
+      if constexpr (has_fields<Reference>::value)
+        _f_swap_impl(a, b,
+                     std::make_index_sequence<Reference::number_of_fields>{});
+      else if constexpr (!std::is_same<Reference, __skipped_field>::value)
+        std::swap(a, b);
+    }
+
+    template <class Reference, size_t... I>
+    inline void _f_swap_impl(Reference &a, Reference &b,
+                             std::index_sequence<I...>) {
+      (_f_swap(get_field<I>(a), get_field<I>(b)), ...);
+    }
+
+    template <class Container> class __proxy_reference : public Container {
+
+    public:
+      /// Type of the values of the elements
+      using value_type = extract_value_type_t<Container>;
+
+      /// Inherit constructors
+      using Container::Container;
+
+      /// Copy constructor, referring to the same element
+      __proxy_reference(__proxy_reference const &) = default;
+
+      /// Assign the values of the fields of another element. Like the rest
+      /// of assignments, it can be called on constant references, since it
+      /// only modifies the referred values.
+      __proxy_reference const &operator=(__proxy_reference const &other) const {
+        _f_assign(const_cast<__proxy_reference &>(*this), other);
+        return *this;
+      }
+
+      /// Assign the values of the fields of an object, or of an element of
+      /// another container
+      template <class Value,
+                class = std::enable_if_t<has_fields<Value>::value>>
+      __proxy_reference const &operator=(Value const &value) const {
+        _f_assign(const_cast<__proxy_reference &>(*this), value);
+        return *this;
+      }
+
+      /// Copy the values of the fields
+      operator value_type() const { return _f_to_value(*this); }
+
+      /// Swap the values of the fields of two elements
+      friend void swap(__proxy_reference a, __proxy_reference b) {
+        _f_swap(a, b);
+      }
+    };
+  } // namespace core
+
+  namespace traits {
+
+    /// The prototype of a reference is that of the container type
+    template <class Container>
+    struct extract_prototype<core::__proxy_reference<Container>>
+        : extract_prototype<Container> {};
+  } // namespace traits
 } // namespace smit
 
 #endif
@@ -1,113 +1,265 @@
 #ifndef SMARTIT_VECTOR_HPP
 #define SMARTIT_VECTOR_HPP
 
-#include <vector>
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <tuple>
 
+#include "expression.hpp"
 #include "iterator.hpp"
+#include "layout.hpp"
+#include "memory.hpp"
+#include "simd.hpp"
 
 namespace smit {
 
-  // Forward declaration of the vector class
-  template <class Object, template <class> class Alloc> class vector;
   namespace core {
 
-    /// Proxy for a vector, storing its type and iterator
-    template <class Type, template <class> class Alloc, class Enable = void>
-    struct vector_proxy {}; // primary template
-
-    template <class Type, template <class> class Alloc>
-    struct vector_proxy<
-        Type, Alloc,
-        typename std::enable_if<std::is_arithmetic<Type>::value>::type> {
-      using type = std::vector<Type, Alloc<Type>>;
-      using iterator = typename type::iterator;
-      using const_iterator = typename type::const_iterator;
+    template <class Object> class __vector_columns;
+
+    /// Type of the column of a field in a vector
+    template <class Type, class Enable = void>
+    struct vector_column {}; // primary template
+
+    /// Arithmetic fields are stored as columns in the block of the vector
+    template <class Type>
+    struct vector_column<
+        Type, typename std::enable_if<std::is_arithmetic<Type>::value>::type> {
+      using type = Type *;
     };
 
-    template <class Type, template <class> class Alloc>
-    struct vector_proxy<
-        Type, Alloc,
+    /// Nested data objects hold the columns of their fields, also stored in
+    /// the block of the vector
+    template <class Type>
+    struct vector_column<
+        Type,
         typename std::enable_if<!std::is_arithmetic<Type>::value>::type> {
-      using type = vector<Type, Alloc>;
-      using iterator = typename type::iterator;
-      using const_iterator = typename type::const_iterator;
+      using type = __vector_columns<Type>;
     };
 
-    template <class Type, template <class> class Alloc>
-    using vector_proxy_t = typename vector_proxy<Type, Alloc>::type;
+    template <class Type>
+    using vector_column_t = typename vector_column<Type>::type;
 
-    // Auxiliar function to determine the vector type
-    template <template <class> class Alloc, class... Types>
-    constexpr auto _f_vector_base(utils::types_holder<Types...>) {
-      return std::tuple<vector_proxy_t<Types, Alloc>...>{};
+    // Auxiliar function to determine the tuple of columns
+    template <class... Types>
+    constexpr auto _f_vector_columns_base(utils::types_holder<Types...>) {
+      return utils::type_wrapper<std::tuple<vector_column_t<Types>...>>{};
     }
 
-    /// Container of the base type for vector objects
-    template <class H, template <class> class Alloc> struct vector_base {
-      using type = decltype(_f_vector_base<Alloc>(H{}));
+    /// Tuple of the columns of the fields of an object in a vector
+    template <class Object>
+    using vector_columns_base_t = typename decltype(
+        _f_vector_columns_base(typename Object::types{}))::type;
+
+    /**
+     * @brief Columns of the fields of an object in a vector
+     *
+     * Nested data objects do not own any memory: the columns of all the
+     * arithmetic fields, at any depth, are carved out of the block of the
+     * vector, so an object with nested fields is stored as a flat set of
+     * columns.
+     */
+    template <class Object>
+    class __vector_columns : public vector_columns_base_t<Object> {
+
+    public:
+      /// Tuple of columns
+      using base_class = vector_columns_base_t<Object>;
+      /// Type of the container returned on access
+      using reference =
+          __container_type<traits::extract_prototype<Object>::template type,
+                           false, typename Object::types>;
+      /// Type of the container returned on access (constant)
+      using const_reference =
+          __container_type<traits::extract_prototype<Object>::template type,
+                           true, typename Object::types>;
+
+      /// Access the given element
+      reference operator[](size_t i) { return reference(*this, i); }
+
+      /// Access the given element (constant)
+      const_reference operator[](size_t i) const {
+        return const_reference(*this, i);
+      }
     };
 
-    /// Base type for vector objects
-    template <class H, template <class> class Alloc>
-    using vector_base_t = typename vector_base<H, Alloc>::type;
+    /// Tuple from which a set of columns derives (only used to deduce it)
+    template <class... Types>
+    std::tuple<Types...> _f_tuple_base(std::tuple<Types...> const &);
+
+    /// Check whether a type holds the columns of the fields of an object,
+    /// rather than the column of an arithmetic field
+    template <class T, class Enable = void>
+    struct is_column_set : std::false_type {};
+
+    template <class T>
+    struct is_column_set<
+        T, std::void_t<decltype(_f_tuple_base(std::declval<T const &>()))>>
+        : std::true_type {};
+
+    template <class Function, size_t... I, class... Columns>
+    inline void _f_for_each_column_impl(Function &f, std::index_sequence<I...>,
+                                        Columns &... columns);
+
+    /**
+     * @brief Call a function on the columns of the arithmetic fields
+     *
+     * The columns are visited in depth-first order. Several sets of columns
+     * of the same object can be given, in which case the function receives
+     * the columns of the same field of each of them. Columns are pointers
+     * for vectors and std::array objects for arrays.
+     */
+    template <class Function, class First, class... Columns>
+    inline void _f_for_each_column(Function &&f, First &first,
+                                   Columns &... columns) {
+      using type = std::remove_const_t<First>;
+      if constexpr (!is_column_set<type>::value)
+        f(first, columns...);
+      else
+        _f_for_each_column_impl(
+            f,
+            std::make_index_sequence<std::tuple_size<decltype(
+                _f_tuple_base(std::declval<type const &>()))>::value>{},
+            first, columns...);
+    }
 
-    template <template <class> class Alloc> struct alloc_vector_proxy {
-      template <class Type> using type = vector_proxy_t<Type, Alloc>;
-    };
+    /// Call a function on the columns of the I-th field
+    template <size_t I, class Function, class... Columns>
+    inline void _f_for_each_column_of(Function &f, Columns &... columns) {
+      _f_for_each_column(f, std::get<I>(columns)...);
+    }
 
-    /// Create a tuple of vectors with the given size
-    template <template <class> class Alloc, class... Types>
-    constexpr std::tuple<vector_proxy_t<Types, Alloc>...>
-    make_vector_tuple(size_t n, utils::types_holder<Types...>) {
-      return {vector_proxy_t<Types, Alloc>(n)...};
+    template <class Function, size_t... I, class... Columns>
+    inline void _f_for_each_column_impl(Function &f, std::index_sequence<I...>,
+                                        Columns &... columns) {
+      (_f_for_each_column_of<I>(f, columns...), ...);
+    }
+
+    template <class... Types>
+    constexpr size_t _f_column_lines_impl(size_t capacity,
+                                          utils::types_holder<Types...>) {
+      return (0 + ... + _f_cache_lines<Types>(capacity));
+    }
+
+    /// Number of cache lines needed to store the columns of the arithmetic
+    /// fields of an object with the given capacity, each starting at a
+    /// cache line boundary
+    template <class Object>
+    constexpr size_t _f_column_lines(size_t capacity) {
+      return _f_column_lines_impl(capacity, leaf_types_t<Object>{});
     }
   } // namespace core
 
   /**
-   * @brief Definition of a vector based on the std::vector class
+   * @brief Definition of a vector storing the fields in columns
+   *
+   * The columns of the arithmetic fields, including those of the nested
+   * data objects, are carved out of a single memory block, aligned to a
+   * cache line. Each column starts at a cache line boundary, at an offset
+   * that only depends on the capacity of the vector, so changing the
+   * capacity requires a single allocation and one copy per column.
+   *
+   * Columns are padded to the end of their last cache line, whose values
+   * after the last element are unspecified, so batches of up to a cache
+   * line can be accessed as a whole (see smit::vector::for_each_padded_batch).
    */
   template <class Object, template <class> class Alloc = std::allocator>
-  class vector : public core::vector_base_t<typename Object::types, Alloc> {
+  class vector : public core::__vector_columns<Object> {
 
   public:
     /// Base class
-    using base_class = core::vector_base_t<typename Object::types, Alloc>;
+    using base_class = core::__vector_columns<Object>;
+    /// Layout policy of the container
+    using layout_type = layout::soa;
+    /// Alignment (in bytes) of the first element of each column
+    static constexpr size_t column_alignment = core::cache_line_size;
+    /// Allocator of the memory block
+    using allocator_type = Alloc<core::__cache_line>;
+    /// Type of the elements
+    using value_type = Object;
     /// Vector iterator
-    using iterator =
-        core::__iterator<core::alloc_vector_proxy<Alloc>::template type,
-                         Object>;
+    using iterator = core::__iterator<base_class, Object>;
     /// Vector constant iterator
-    using const_iterator =
-        core::__const_iterator<core::alloc_vector_proxy<Alloc>::template type,
-                               Object>;
+    using const_iterator = core::__const_iterator<base_class, Object>;
+    /// Type of the container returned on access
+    using reference = typename iterator::reference;
+    /// Type of the container returned on access (constant)
+    using const_reference = typename const_iterator::reference;
+    /// Type of the distance between iterators
+    using difference_type = typename iterator::difference_type;
 
     /// Default constructor
-    vector() {}
+    vector() : base_class{} {}
     /// Construct the vector from a size
-    vector(size_t n)
-        : base_class{
-              core::make_vector_tuple<Alloc>(n, typename Object::types{})} {};
+    vector(size_t n) : base_class{} { this->resize(n); }
+    /// Construct an empty vector using the given allocator
+    explicit vector(allocator_type const &allocator)
+        : base_class{}, m_allocator{allocator} {}
+    /// Construct the vector from a size, using the given allocator
+    vector(size_t n, allocator_type const &allocator)
+        : base_class{}, m_allocator{allocator} {
+      this->resize(n);
+    }
+    /// Copy constructor
+    vector(vector const &other)
+        : base_class{}, m_allocator{allocator_traits::
+                                        select_on_container_copy_construction(
+                                            other.m_allocator)} {
+      this->reserve(other.size());
+      if (other.m_size != 0)
+        core::_f_for_each_column(
+            [&other](auto &column, auto const &other_column) {
+              std::memcpy(column, other_column,
+                          other.m_size * sizeof(*column));
+            },
+            static_cast<base_class &>(*this),
+            static_cast<base_class const &>(other));
+      m_size = other.m_size;
+    }
+    /// Move constructor
+    vector(vector &&other) : base_class{}, m_allocator{other.m_allocator} {
+      this->swap(other);
+    }
+    /// Construct the vector evaluating an expression
+    template <class Expression,
+              class = std::enable_if_t<core::is_expression<Expression>::value>>
+    vector(Expression const &expression) : base_class{} {
+      *this = expression;
+    }
     /// Destructor
-    ~vector() {}
+    ~vector() { this->deallocate(); }
 
-    inline typename iterator::value_type &operator[](size_t i) {
-      return this->at(i);
+    /// Assignment operator
+    vector &operator=(vector other) {
+      this->swap(other);
+      return *this;
     }
 
-    inline typename iterator::value_type const &operator[](size_t i) const {
-      return this->at(i);
+    /// Evaluate an expression, storing the result in the vector. Elements
+    /// are only combined with those at the same position, so the vector can
+    /// be an operand of the expression.
+    template <class Expression,
+              class = std::enable_if_t<core::is_expression<Expression>::value>>
+    vector &operator=(Expression const &expression) {
+      this->resize(expression.size());
+      core::_f_evaluate<column_alignment>(
+          expression, static_cast<base_class &>(*this), m_size);
+      return *this;
     }
 
+    inline reference operator[](size_t i) { return this->at(i); }
+
+    inline const_reference operator[](size_t i) const { return this->at(i); }
+
     /// Returns a reference at position i in the vector
-    typename iterator::value_type &at(size_t i) {
-      return this->at_impl(
-          i, std::make_index_sequence<Object::number_of_fields>{});
+    reference at(size_t i) {
+      return reference(static_cast<base_class &>(*this), i);
     }
 
     /// Returns a reference at position i in the vector (constant)
-    typename iterator::value_type const &at(size_t i) const {
-      return this->at_impl(
-          i, std::make_index_sequence<Object::number_of_fields>{});
+    const_reference at(size_t i) const {
+      return const_reference(static_cast<base_class const &>(*this), i);
     }
 
     /// Test whether the vector is empty
@@ -116,112 +268,231 @@ namespace smit {
     /// Requests that the vector capacity of each field be at least enough to
     /// contain n elements.
     void reserve(size_t n) {
-      this->reserve_impl(n,
-                         std::make_index_sequence<Object::number_of_fields>{});
+      if (n > m_capacity)
+        this->reallocate(n);
     }
 
     /// Change size
     void resize(size_t n) {
-      this->resize_impl(n,
-                        std::make_index_sequence<Object::number_of_fields>{});
+      this->grow(n);
+      if (n > m_size)
+        core::_f_for_each_column(
+            [this, n](auto &column) {
+              std::fill(column + m_size, column + n,
+                        std::remove_reference_t<decltype(*column)>{});
+            },
+            static_cast<base_class &>(*this));
+      m_size = n;
+    }
+
+    /// Add an element at the end of the vector, copying the fields of the
+    /// given value (or container type)
+    template <class T> void push_back(T const &obj) {
+
+      static_assert(T::number_of_fields == Object::number_of_fields,
+                    "The number of fields of the element does not match that "
+                    "of the vector");
+
+      if (m_size == m_capacity) {
+        // the argument might refer to an element of this vector, so its
+        // fields are copied before the memory is released
+        auto const value = core::_f_to_value(obj);
+        this->grow(m_size + 1);
+        core::_f_assign(this->at(m_size), value);
+      } else
+        core::_f_assign(this->at(m_size), obj);
+      ++m_size;
+    }
+
+    /// Add an element at the end of the vector, building each field from
+    /// one of the arguments
+    template <class... Args> reference emplace_back(Args &&... args) {
+
+      static_assert(sizeof...(Args) == Object::number_of_fields,
+                    "The number of arguments must match the number of fields");
+
+      if (m_size == m_capacity) {
+        // the arguments might refer to fields of this vector
+        auto values = std::make_tuple(core::_f_to_value(args)...);
+        this->grow(m_size + 1);
+        this->emplace_back_impl(
+            std::move(values),
+            std::make_index_sequence<Object::number_of_fields>{});
+      } else
+        this->emplace_back_impl(
+            std::forward_as_tuple(std::forward<Args>(args)...),
+            std::make_index_sequence<Object::number_of_fields>{});
+
+      return this->at(m_size++);
     }
 
     /// Get the size of the vector
-    inline size_t size() const {
+    inline size_t size() const { return m_size; }
+
+    /// Number of elements that can be held without reallocating
+    inline size_t capacity() const { return m_capacity; }
+
+    /// Allocator of the memory block
+    allocator_type get_allocator() const { return m_allocator; }
+
+    /// Swap the contents of two vectors
+    void swap(vector &other) {
+      std::swap(static_cast<base_class &>(*this),
+                static_cast<base_class &>(other));
+      std::swap(m_allocator, other.m_allocator);
+      std::swap(m_block, other.m_block);
+      std::swap(m_size, other.m_size);
+      std::swap(m_capacity, other.m_capacity);
+    }
 
-      if constexpr (Object::number_of_fields == 0)
-        return 0;
-      else
-        return std::get<0>(*this).size();
+    /// Call a function on batches of W consecutive elements. The function
+    /// receives a smit::simd::batch and, optionally, the number of active
+    /// lanes. The last batch is masked if the size is not a multiple of W.
+    template <size_t W = simd::default_width<Object>, class Function>
+    void for_each_batch(Function &&f) {
+      core::_f_for_each_batch<W, Object, column_alignment>(
+          static_cast<base_class &>(*this), m_size, f);
     }
 
-    /// Begining of the vector
-    auto begin() {
-      return this->begin_impl(
-          std::make_index_sequence<Object::number_of_fields>{});
+    /// Call a function on batches of W consecutive elements (constant). The
+    /// batches are not stored back in the vector.
+    template <size_t W = simd::default_width<Object>, class Function>
+    void for_each_batch(Function &&f) const {
+      core::_f_for_each_batch<W, Object, column_alignment>(
+          static_cast<base_class const &>(*this), m_size, f);
     }
 
-    /// Begining of the vector (constant)
-    auto begin() const {
-      return this->cbegin_impl(
-          std::make_index_sequence<Object::number_of_fields>{});
+    /// Call a function on batches of W consecutive elements, accessing the
+    /// last batch as a whole, using the padding of the columns. The inactive
+    /// lanes of the last batch have unspecified values, and any value
+    /// stored in them is discarded.
+    template <size_t W = simd::default_width<Object>, class Function>
+    void for_each_padded_batch(Function &&f) {
+      static_assert(W * core::_f_max_field_size<Object>() <= column_alignment,
+                    "Batches can not be larger than the padding");
+      core::_f_for_each_batch<W, Object, column_alignment, true>(
+          static_cast<base_class &>(*this), m_size, f);
     }
 
-    /// Begining of the vector (constant)
-    auto cbegin() {
-      return this->cbegin_impl(
-          std::make_index_sequence<Object::number_of_fields>{});
+    /// Call a function on batches of W consecutive elements, accessing the
+    /// last batch as a whole (constant). The batches are not stored back in
+    /// the vector.
+    template <size_t W = simd::default_width<Object>, class Function>
+    void for_each_padded_batch(Function &&f) const {
+      static_assert(W * core::_f_max_field_size<Object>() <= column_alignment,
+                    "Batches can not be larger than the padding");
+      core::_f_for_each_batch<W, Object, column_alignment, true>(
+          static_cast<base_class const &>(*this), m_size, f);
     }
 
-    /// End of the vector
-    auto end() {
-      return this->end_impl(
-          std::make_index_sequence<Object::number_of_fields>{});
+    /// Pointer to the column of an arithmetic field, given by its position
+    /// and, for nested data objects, those of the fields inside them
+    template <size_t... I> auto data() {
+      return core::_f_assume_aligned<column_alignment>(
+          core::_f_column_data(core::_f_column<I...>(
+              static_cast<base_class &>(*this))));
     }
 
-    /// End of the vector (constant)
-    auto end() const {
-      return this->cend_impl(
-          std::make_index_sequence<Object::number_of_fields>{});
+    /// Pointer to the column of an arithmetic field (constant)
+    template <size_t... I> auto data() const {
+      return core::_f_assume_aligned<column_alignment>(
+          core::_f_column_data(core::_f_column<I...>(
+              static_cast<base_class const &>(*this))));
     }
 
+    /// Begining of the vector
+    iterator begin() { return {*this, 0}; }
+
+    /// Begining of the vector (constant)
+    const_iterator begin() const { return {*this, 0}; }
+
+    /// Begining of the vector (constant)
+    const_iterator cbegin() const { return {*this, 0}; }
+
+    /// End of the vector
+    iterator end() { return {*this, difference_type(m_size)}; }
+
     /// End of the vector (constant)
-    auto cend() {
-      return this->cend_impl(
-          std::make_index_sequence<Object::number_of_fields>{});
-    }
+    const_iterator end() const { return {*this, difference_type(m_size)}; }
+
+    /// End of the vector (constant)
+    const_iterator cend() const { return {*this, difference_type(m_size)}; }
 
   private:
-    /// Implementation of the at function
-    template <size_t... I>
-    typename iterator::value_type &at_impl(size_t i,
-                                           std::index_sequence<I...>) {
-      return *(this->begin() + i);
+    /// Traits of the allocator
+    using allocator_traits = std::allocator_traits<allocator_type>;
+
+    /// Type of the field at the given position
+    template <size_t I>
+    using field_type = utils::tuple_element_for_t<I, typename Object::types>;
+
+    /// Allocator of the memory block
+    allocator_type m_allocator;
+    /// Memory block storing the arithmetic columns
+    core::__cache_line *m_block = nullptr;
+    /// Number of elements
+    size_t m_size = 0;
+    /// Number of elements that fit in the memory block
+    size_t m_capacity = 0;
+
+    /// Make room for at least n elements, growing the capacity of all the
+    /// fields geometrically
+    inline void grow(size_t n) {
+      if (n > m_capacity)
+        this->reallocate(std::max(n, 2 * m_capacity));
     }
 
-    /// Implementation of the at function (constant)
-    template <size_t... I>
-    typename iterator::value_type const &
-    at_impl(size_t i, std::index_sequence<I...>) const {
-      return *(this->cbegin() + i);
+    /// Implementation of the emplace_back function
+    template <class Tuple, size_t... I>
+    inline void emplace_back_impl(Tuple &&args, std::index_sequence<I...>) {
+      (this->append_field<I>(std::get<I>(std::move(args))), ...);
     }
 
-    /// Implementation of the begin function
-    template <size_t... I> iterator begin_impl(std::index_sequence<I...>) {
-
-      return {std::begin(std::get<I>(*this))...};
-    };
+    /// Set the value of a field for the element after the last
+    template <size_t I, class T> inline void append_field(T &&value) {
+      if constexpr (std::is_arithmetic<field_type<I>>::value)
+        std::get<I>(*this)[m_size] = std::forward<T>(value);
+      else
+        core::_f_assign(std::get<I>(*this)[m_size], value);
+    }
 
-    /// Implementation of the cbegin function
-    template <size_t... I>
-    const_iterator cbegin_impl(std::index_sequence<I...>) const {
+    /// Number of cache lines needed to store the arithmetic columns
+    static constexpr size_t block_lines(size_t capacity) {
+      return core::_f_column_lines<Object>(capacity);
+    }
 
-      return {std::cbegin(std::get<I>(*this))...};
-    };
+    /// Move the elements to a new memory block with the given capacity
+    void reallocate(size_t capacity) {
 
-    /// Implementation of the end function
-    template <size_t... I> iterator end_impl(std::index_sequence<I...>) {
+      auto const lines = block_lines(capacity);
 
-      return {std::end(std::get<I>(*this))...};
-    };
+      core::__cache_line *block =
+          lines != 0 ? allocator_traits::allocate(m_allocator, lines)
+                     : nullptr;
 
-    /// Implementation of the cend function
-    template <size_t... I>
-    const_iterator cend_impl(std::index_sequence<I...>) const {
+      size_t offset = 0;
+      core::_f_for_each_column(
+          [this, block, capacity, &offset](auto &column) {
+            using type = std::remove_reference_t<decltype(*column)>;
+            auto c = reinterpret_cast<type *>(block + offset);
+            if (m_size != 0)
+              std::memcpy(c, column, m_size * sizeof(type));
+            column = c;
+            offset += core::_f_cache_lines<type>(capacity);
+          },
+          static_cast<base_class &>(*this));
 
-      return {std::cend(std::get<I>(*this))...};
-    };
+      this->deallocate();
 
-    /// Implementation of the reserve function
-    template <size_t... I>
-    inline void reserve_impl(size_t n, std::index_sequence<I...>) {
-      (std::get<I>(*this).reserve(n), ...);
+      m_block = block;
+      m_capacity = capacity;
     }
 
-    /// Implementation of the resize function
-    template <size_t... I>
-    inline void resize_impl(size_t n, std::index_sequence<I...>) {
-      (std::get<I>(*this).resize(n), ...);
+    /// Release the memory block
+    void deallocate() {
+      if (m_block != nullptr)
+        allocator_traits::deallocate(m_allocator, m_block,
+                                     block_lines(m_capacity));
     }
   };
 } // namespace smit
@@ -0,0 +1,113 @@
+#include <type_traits>
+
+#include "smartit/aggregate.hpp"
+#include "smartit/execution.hpp"
+#include "smartit/test.hpp"
+#include "smartit/types.hpp"
+#include "smartit/vector.hpp"
+
+template <typename Type, class Policy, class Strategy>
+void check_reduce_by_key(Policy const &policy, Strategy strategy) {
+
+  // several chunks for the parallel policies
+  size_t const size = 3 * smit::core::parallel_grain + 7;
+  size_t const groups = 17;
+
+  // the key of each point is in the X coordinate, and the value of the
+  // element within its group in Y
+  smit::vector<smit::point_3d<Type>> a(size);
+  for (size_t i = 0; i < size; ++i) {
+    a[i].x() = Type((i * 7919) % groups);
+    a[i].y() = Type(i / groups % 8);
+    a[i].z() = Type(1);
+  }
+
+  auto r = smit::reduce_by_key(
+      policy, strategy, a, [](auto const &p) { return int(p.x()); },
+      smit::aggregate::count(),
+      smit::aggregate::sum([](auto const &p) { return p.z(); }),
+      smit::aggregate::min([](auto const &p) { return p.y(); }),
+      smit::aggregate::max([](auto const &p) { return p.y(); }),
+      smit::aggregate::mean([](auto const &p) { return p.z(); }));
+
+  using group_type = typename decltype(r)::value_type;
+  static_assert(std::is_same<std::decay_t<decltype(
+                                 std::declval<group_type>().key())>,
+                             int>::value,
+                "Wrong type of key");
+
+  auto counts = [&r, size]() {
+    size_t total = 0;
+    for (size_t g = 0; g < r.size(); ++g) {
+      if (r[g].key() != int(g) ||
+          Type(r[g].template value<0>()) != r[g].template value<1>())
+        return false;
+      total += r[g].template value<0>();
+    }
+    return total == size;
+  };
+  SMARTIT_TEST_ASSERT([&r]() { return r.size(); }, groups);
+  SMARTIT_TEST_ASSERT(counts, true);
+
+  auto extrema = [&r]() {
+    for (size_t g = 0; g < r.size(); ++g)
+      if (r[g].template value<2>() != Type(0) ||
+          r[g].template value<3>() != Type(7) ||
+          r[g].template value<4>() != 1)
+        return false;
+    return true;
+  };
+  SMARTIT_TEST_ASSERT(extrema, true);
+}
+
+template <typename Type> void test_reduce_by_key() {
+  check_reduce_by_key<Type>(smit::execution::seq, smit::grouping::sort);
+  check_reduce_by_key<Type>(smit::execution::seq, smit::grouping::hash);
+  check_reduce_by_key<Type>(smit::execution::par, smit::grouping::sort);
+  check_reduce_by_key<Type>(smit::execution::par, smit::grouping::hash);
+}
+
+template <typename Type> void test_defaults() {
+
+  // nested data objects, without policy nor strategy
+  smit::vector<smit::point_with_vector_3d<Type>> v(10);
+  for (size_t i = 0; i < v.size(); ++i) {
+    v[i].point().x() = Type(i % 3);
+    v[i].vector().y() = Type(i);
+  }
+
+  auto r = smit::reduce_by_key(
+      v, [](auto const &p) { return p.point().x(); },
+      smit::aggregate::sum([](auto const &p) { return p.vector().y(); }),
+      smit::aggregate::mean([](auto const &p) { return p.vector().y(); }));
+
+  // groups {0, 3, 6, 9}, {1, 4, 7} and {2, 5, 8}
+  auto values = [&r]() {
+    return r.size() == 3 && r[0].key() == Type(0) &&
+           r[0].template value<0>() == Type(18) &&
+           r[1].template value<0>() == Type(12) &&
+           r[2].template value<0>() == Type(15) &&
+           r[0].template value<1>() == 4.5 && r[2].template value<1>() == 5;
+  };
+  SMARTIT_TEST_ASSERT(values, true);
+
+  // empty containers give no groups
+  smit::vector<smit::point_with_vector_3d<Type>> e;
+  auto none = smit::reduce_by_key(
+      smit::execution::par, e, [](auto const &p) { return p.point().x(); },
+      smit::aggregate::count());
+  SMARTIT_TEST_ASSERT([&none]() { return none.empty(); }, true);
+}
+
+int main() {
+
+  smit::test::test_collector coll("test-aggregate");
+  SMARTIT_TEST_SCOPE_FUNCTION(coll, &test_reduce_by_key<int>);
+  SMARTIT_TEST_SCOPE_FUNCTION(coll, &test_reduce_by_key<float>);
+  SMARTIT_TEST_SCOPE_FUNCTION(coll, &test_reduce_by_key<double>);
+  SMARTIT_TEST_SCOPE_FUNCTION(coll, &test_defaults<int>);
+  SMARTIT_TEST_SCOPE_FUNCTION(coll, &test_defaults<float>);
+  SMARTIT_TEST_SCOPE_FUNCTION(coll, &test_defaults<double>);
+
+  return coll.status();
+}
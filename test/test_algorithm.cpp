@@ -0,0 +1,386 @@
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "smartit/algorithm.hpp"
+#include "smartit/test.hpp"
+#include "smartit/types.hpp"
+#include "smartit/vector.hpp"
+
+template <typename Type, class Policy>
+void check_algorithms(Policy const &policy) {
+
+  // several chunks for the parallel policies
+  size_t const size = 3 * smit::core::parallel_grain + 7;
+
+  smit::vector<smit::point_3d<Type>> a(size), b(size);
+
+  smit::for_each(policy, a.begin(), a.end(), [](auto p) {
+    p.x() = 1;
+    p.y() = 2;
+  });
+
+  // elements are also bound as forwarding references
+  smit::for_each(policy, a.begin(), a.end(), [](auto &&p) { p.z() = 3; });
+
+  smit::transform(policy, a.cbegin(), a.cend(), b.begin(), [](auto const &p) {
+    return smit::point_3d<Type>{p.z(), p.y(), p.x()};
+  });
+
+  auto check = [&b]() {
+    for (auto it = b.cbegin(); it != b.cend(); ++it)
+      if (it->x() != 3 || it->y() != 2 || it->z() != 1)
+        return false;
+    return true;
+  };
+  SMARTIT_TEST_ASSERT(check, true);
+
+  // output to a standard container
+  std::vector<Type> d(size);
+  smit::transform(policy, a.cbegin(), a.cend(), b.cbegin(), d.begin(),
+                  [](auto const &u, auto const &v) { return smit::dot(u, v); });
+
+  auto dot = [&d]() {
+    for (auto v : d)
+      if (v != 10)
+        return false;
+    return true;
+  };
+  SMARTIT_TEST_ASSERT(dot, true);
+
+  auto sum = smit::reduce(
+      policy, a.cbegin(), a.cend(), smit::point_3d<Type>{0, 0, 0},
+      [](auto const &u, auto const &v) {
+        return smit::point_3d<Type>{u.x() + v.x(), u.y() + v.y(),
+                                    u.z() + v.z()};
+      });
+
+  SMARTIT_TEST_ASSERT(sum.x, Type(size));
+  SMARTIT_TEST_ASSERT(sum.z, Type(3 * size));
+
+  auto mod2 = smit::transform_reduce(
+      policy, a.cbegin(), a.cend(), Type(0),
+      [](Type u, Type v) { return u + v; },
+      [](auto const &p) { return p.mod2(); });
+
+  SMARTIT_TEST_ASSERT([&mod2]() { return mod2; }, Type(14 * size));
+}
+
+template <typename Type> void test_algorithms() {
+  check_algorithms<Type>(smit::execution::seq);
+  check_algorithms<Type>(smit::execution::par);
+  check_algorithms<Type>(smit::execution::par_unseq);
+}
+
+template <typename Type, class Policy> void check_sort(Policy const &policy) {
+
+  // several chunks for the parallel policies
+  size_t const size = 3 * smit::core::parallel_grain + 7;
+
+  smit::vector<smit::point_3d<Type>> a(size);
+  for (size_t i = 0; i < size; ++i) {
+    a[i].x() = Type((i * 7919) % 100);
+    a[i].y() = Type(i % 1000);
+    a[i].z() = Type(2 * (i % 1000));
+  }
+
+  auto b = a;
+
+  smit::sort(policy, a, [](auto const &p) { return p.x(); });
+  smit::stable_sort(policy, b, [](auto const &p) { return p.x(); });
+
+  // the fields of each element are moved together
+  auto sorted = [&a]() {
+    for (size_t i = 0; i < a.size(); ++i)
+      if ((i != 0 && a[i].x() < a[i - 1].x()) || a[i].z() != 2 * a[i].y())
+        return false;
+    return a.size() == size;
+  };
+  SMARTIT_TEST_ASSERT(sorted, true);
+
+  // equivalent keys keep the original order (the positions are increasing
+  // modulo 1000)
+  auto stable = [&b]() {
+    for (size_t i = 1; i < b.size(); ++i)
+      if (b[i].x() < b[i - 1].x() || b[i].z() != 2 * b[i].y() ||
+          (b[i].x() == b[i - 1].x() && b[i].y() < b[i - 1].y() &&
+           b[i - 1].y() - b[i].y() < 900))
+        return false;
+    return true;
+  };
+  SMARTIT_TEST_ASSERT(stable, true);
+
+  // descending order
+  smit::sort(
+      policy, a, [](auto const &p) { return p.y(); }, std::greater<>{});
+  SMARTIT_TEST_ASSERT([&a]() { return a[0].y(); }, Type(999));
+  SMARTIT_TEST_ASSERT([&a]() { return a[size - 1].z(); }, Type(0));
+}
+
+template <typename Type> void test_sort() {
+  check_sort<Type>(smit::execution::seq);
+  check_sort<Type>(smit::execution::par);
+
+  // nested data objects, without execution policy
+  smit::vector<smit::point_with_vector_3d<Type>> v(100);
+  for (size_t i = 0; i < v.size(); ++i) {
+    v[i].point().x() = Type(99 - i);
+    v[i].vector().z() = Type(i);
+  }
+
+  smit::sort(v, [](auto const &p) { return p.point().x(); });
+
+  auto nested = [&v]() {
+    for (size_t i = 0; i < v.size(); ++i)
+      if (v[i].point().x() != Type(i) || v[i].vector().z() != Type(99 - i))
+        return false;
+    return true;
+  };
+  SMARTIT_TEST_ASSERT(nested, true);
+}
+
+template <typename Type> void test_filter() {
+
+  // the size is not a multiple of the number of lanes
+  size_t const size = 1003;
+
+  smit::vector<smit::point_with_vector_3d<Type>> a(size);
+  for (size_t i = 0; i < size; ++i) {
+    a[i].point().x() = Type(i % 10);
+    a[i].vector().y() = Type(i);
+  }
+
+  auto small = [](auto const &b) { return b.point().x() < Type(3); };
+
+  // out of place, into a reserved container
+  smit::vector<smit::point_with_vector_3d<Type>> b;
+  b.reserve(size);
+  auto const data = b.template data<1, 1>();
+
+  auto const selected = smit::filter(a, b, small);
+
+  auto filtered = [&]() {
+    for (size_t j = 0; j < b.size(); ++j)
+      if (b[j].vector().y() != Type(10 * (j / 3) + j % 3) ||
+          b[j].point().x() != Type(j % 3))
+        return false;
+    return selected == b.size() && b.template data<1, 1>() == data;
+  };
+  SMARTIT_TEST_ASSERT(filtered, true);
+  SMARTIT_TEST_ASSERT(b.size, size_t(303));
+
+  auto c = smit::filter(a, small);
+  SMARTIT_TEST_ASSERT(c.size, size_t(303));
+
+  // in place, keeping the order of the rest
+  auto const removed = smit::erase_if(a, small);
+
+  auto erased = [&]() {
+    for (size_t j = 0; j < a.size(); ++j)
+      if (a[j].vector().y() != Type(10 * (j / 7) + j % 7 + 3) ||
+          a[j].point().x() != Type(j % 7 + 3))
+        return false;
+    return removed == 303 && a.size() == size - 303;
+  };
+  SMARTIT_TEST_ASSERT(erased, true);
+
+  // nothing to remove
+  SMARTIT_TEST_ASSERT(
+      [&a]() {
+        return smit::erase_if(
+            a, [](auto const &b) { return b.point().mod2() < 0; });
+      },
+      size_t(0));
+  SMARTIT_TEST_ASSERT(a.size, size - 303);
+
+  // several blocks, removing whole blocks and keeping others intact
+  size_t const large = 3 * smit::core::compaction_block + 5;
+
+  smit::vector<smit::point_3d<Type>> l(large);
+  for (size_t i = 0; i < large; ++i)
+    l[i].x() = Type(i / smit::core::compaction_block == 1 ? 0 : i % 2 + 1);
+
+  auto odd = [](auto const &b) { return b.x() == Type(2); };
+
+  smit::vector<smit::point_3d<Type>> m;
+  m.reserve(large);
+  auto const m_data = m.template data<0>();
+
+  smit::filter(l, m, odd);
+  auto const l_removed = smit::erase_if(
+      l, [](auto const &b) { return b.x() != Type(2); });
+
+  auto blocks = [&]() {
+    if (m.size() != l.size() || m.template data<0>() != m_data)
+      return false;
+    for (size_t j = 0; j < l.size(); ++j)
+      if (l[j].x() != Type(2) || m[j].x() != Type(2))
+        return false;
+    return l_removed + l.size() == large;
+  };
+  SMARTIT_TEST_ASSERT(blocks, true);
+  SMARTIT_TEST_ASSERT(l.size, (2 * smit::core::compaction_block + 5) / 2);
+}
+
+template <typename Type> void test_take_scatter() {
+
+  size_t const size = 1000;
+
+  smit::vector<smit::point_with_vector_3d<Type>> a(size);
+  for (size_t i = 0; i < size; ++i) {
+    a[i].point().x() = Type(i);
+    a[i].vector().z() = Type(2 * i);
+  }
+
+  // random positions, some of them repeated
+  std::vector<std::uint32_t> indices(300);
+  for (size_t j = 0; j < indices.size(); ++j)
+    indices[j] = (j * 7919) % 257;
+
+  auto b = smit::take(a, indices);
+
+  auto taken = [&]() {
+    for (size_t j = 0; j < indices.size(); ++j)
+      if (b[j].point().x() != Type(indices[j]) ||
+          b[j].vector().z() != Type(2 * indices[j]))
+        return false;
+    return b.size() == indices.size();
+  };
+  SMARTIT_TEST_ASSERT(taken, true);
+
+  // write the elements back, shifted
+  std::vector<size_t> positions(indices.size());
+  for (size_t j = 0; j < positions.size(); ++j)
+    positions[j] = indices[j] + 500;
+
+  smit::scatter(a, positions, b);
+
+  auto scattered = [&]() {
+    for (size_t i = 0; i < size; ++i) {
+      auto const expected = (i >= 500 && i < 757) ? i - 500 : i;
+      if (a[i].point().x() != Type(expected) ||
+          a[i].vector().z() != Type(2 * expected))
+        return false;
+    }
+    return true;
+  };
+  SMARTIT_TEST_ASSERT(scattered, true);
+}
+
+template <typename Type, class Policy> void check_scan(Policy const &policy) {
+
+  // several chunks for the parallel policies
+  size_t const size = 3 * smit::core::parallel_grain + 7;
+
+  smit::vector<smit::point_3d<Type>> a(size), b;
+  for (size_t i = 0; i < size; ++i) {
+    a[i].x() = Type(i % 3);
+    a[i].y() = Type(7);
+    a[i].z() = Type(1);
+  }
+
+  smit::inclusive_scan(policy, a, b);
+
+  auto inclusive = [&]() {
+    Type x = 0;
+    for (size_t i = 0; i < size; ++i) {
+      x += Type(i % 3);
+      if (b[i].x() != x || b[i].y() != Type(7 * (i + 1)) ||
+          b[i].z() != Type(i + 1))
+        return false;
+    }
+    return b.size() == size;
+  };
+  SMARTIT_TEST_ASSERT(inclusive, true);
+
+  // only some fields, in place, the rest being untouched
+  smit::exclusive_scan<0, 2>(policy, a);
+
+  auto exclusive = [&]() {
+    Type x = 0;
+    for (size_t i = 0; i < size; ++i) {
+      if (a[i].x() != x || a[i].y() != Type(7) || a[i].z() != Type(i))
+        return false;
+      x += Type(i % 3);
+    }
+    return true;
+  };
+  SMARTIT_TEST_ASSERT(exclusive, true);
+}
+
+template <typename Type> void test_scan() {
+  check_scan<Type>(smit::execution::seq);
+  check_scan<Type>(smit::execution::par);
+
+  // offsets of groups of variable size, from a nested data object
+  smit::vector<smit::point_with_vector_3d<Type>> v(5), offsets;
+  for (size_t i = 0; i < v.size(); ++i) {
+    v[i].point().x() = Type(i + 1);
+    v[i].vector().x() = Type(i);
+  }
+
+  smit::exclusive_scan<0>(v, offsets);
+
+  auto nested = [&]() {
+    Type const expected[] = {0, 1, 3, 6, 10};
+    for (size_t i = 0; i < v.size(); ++i)
+      if (offsets[i].point().x() != expected[i])
+        return false;
+    return offsets.size() == v.size();
+  };
+  SMARTIT_TEST_ASSERT(nested, true);
+
+  smit::inclusive_scan<1>(v);
+  SMARTIT_TEST_ASSERT([&v]() { return v[4].vector().x(); }, Type(10));
+  SMARTIT_TEST_ASSERT([&v]() { return v[4].point().x(); }, Type(5));
+}
+
+void test_parallel_chunks() {
+
+  size_t const size = 1000;
+
+  std::vector<std::atomic<int>> counts(size);
+  std::atomic<size_t> calls{0};
+
+  smit::core::_f_parallel_chunks(size, 4, [&](size_t, size_t begin,
+                                              size_t end) {
+    ++calls;
+    // chunks are aligned to the granularity
+    if (begin % smit::core::chunk_granularity != 0)
+      throw "Chunk not aligned";
+    for (size_t i = begin; i < end; ++i)
+      ++counts[i];
+  });
+
+  auto check = [&]() {
+    for (auto const &c : counts)
+      if (c != 1)
+        return false;
+    return calls == 4;
+  };
+  SMARTIT_TEST_ASSERT(check, true);
+}
+
+int main() {
+
+  smit::test::test_collector coll("test-algorithm");
+  SMARTIT_TEST_SCOPE_FUNCTION(coll, &test_algorithms<int>);
+  SMARTIT_TEST_SCOPE_FUNCTION(coll, &test_algorithms<float>);
+  SMARTIT_TEST_SCOPE_FUNCTION(coll, &test_algorithms<double>);
+  SMARTIT_TEST_SCOPE_FUNCTION(coll, &test_sort<int>);
+  SMARTIT_TEST_SCOPE_FUNCTION(coll, &test_sort<float>);
+  SMARTIT_TEST_SCOPE_FUNCTION(coll, &test_sort<double>);
+  SMARTIT_TEST_SCOPE_FUNCTION(coll, &test_filter<int>);
+  SMARTIT_TEST_SCOPE_FUNCTION(coll, &test_filter<float>);
+  SMARTIT_TEST_SCOPE_FUNCTION(coll, &test_filter<double>);
+  SMARTIT_TEST_SCOPE_FUNCTION(coll, &test_take_scatter<int>);
+  SMARTIT_TEST_SCOPE_FUNCTION(coll, &test_take_scatter<float>);
+  SMARTIT_TEST_SCOPE_FUNCTION(coll, &test_take_scatter<double>);
+  SMARTIT_TEST_SCOPE_FUNCTION(coll, &test_scan<int>);
+  SMARTIT_TEST_SCOPE_FUNCTION(coll, &test_scan<float>);
+  SMARTIT_TEST_SCOPE_FUNCTION(coll, &test_scan<double>);
+  SMARTIT_TEST_SCOPE_FUNCTION(coll, &test_parallel_chunks);
+
+  return coll.status();
+}
@@ -0,0 +1,162 @@
+#include "smartit/arena.hpp"
+#include "smartit/test.hpp"
+#include "smartit/tiled_vector.hpp"
+#include "smartit/types.hpp"
+#include "smartit/vector.hpp"
+
+#include <cstdint>
+#include <new>
+#include <vector>
+
+/// Whether a pointer lies in [first, first + bytes)
+bool in_block(void const *p, void const *first, size_t bytes) {
+  auto const c = static_cast<unsigned char const *>(p);
+  auto const f = static_cast<unsigned char const *>(first);
+  return c >= f && c < f + bytes;
+}
+
+void test_arena() {
+
+  smit::arena a(1024);
+
+  void *first = a.allocate(10, 1);
+  void *second = a.allocate(8, 64);
+
+  auto aligned = [&]() {
+    return reinterpret_cast<std::uintptr_t>(first) % 64 == 0 &&
+           reinterpret_cast<std::uintptr_t>(second) % 64 == 0;
+  };
+  SMARTIT_TEST_ASSERT(aligned, true);
+
+  // allocations larger than the blocks get their own block
+  a.allocate(4096, 8);
+
+  auto blocks = [&]() {
+    return a.number_of_blocks() == 2 && a.capacity() == 1024 + 4096;
+  };
+  SMARTIT_TEST_ASSERT(blocks, true);
+
+  // the memory is reused after a reset, without new blocks
+  a.reset();
+
+  auto reused = [&]() {
+    return a.allocate(10, 1) == first && a.allocate(8, 64) == second &&
+           a.number_of_blocks() == 2;
+  };
+  SMARTIT_TEST_ASSERT(reused, true);
+}
+
+void test_over_aligned() {
+
+  smit::arena a(4096);
+
+  // alignments larger than a cache line, in an existing block and in a new
+  // one
+  a.allocate(8, 8);
+  void *first = a.allocate(16, 256);
+  void *second = a.allocate(8, 128);
+  void *third = a.allocate(4096, 256);
+
+  auto aligned = [&]() {
+    return reinterpret_cast<std::uintptr_t>(first) % 256 == 0 &&
+           reinterpret_cast<std::uintptr_t>(second) % 128 == 0 &&
+           reinterpret_cast<std::uintptr_t>(third) % 256 == 0;
+  };
+  SMARTIT_TEST_ASSERT(aligned, true);
+}
+
+template <class Container> void test_containers() {
+
+  smit::arena a(1u << 16);
+
+  void *first = nullptr;
+
+  for (size_t event = 0; event < 10; ++event) {
+
+    a.reset();
+
+    // start of the free memory
+    void *base = a.allocate(0, 1);
+    if (event == 0)
+      first = base;
+
+    std::vector<Container> containers;
+    containers.reserve(20);
+    for (size_t n = 0; n < 20; ++n) {
+      Container c{a};
+      for (size_t i = 0; i < n; ++i)
+        c.push_back(smit::point_with_vector_3d<float>(
+            smit::point_3d<float>(float(i), 0.f, 0.f),
+            smit::point_3d<float>(0.f, float(i), 0.f)));
+      containers.push_back(std::move(c));
+    }
+
+    auto values = [&]() {
+      for (size_t n = 0; n < containers.size(); ++n) {
+        if (containers[n].size() != n)
+          return false;
+        for (size_t i = 0; i < n; ++i)
+          if (containers[n][i].point().x() != float(i) ||
+              containers[n][i].vector().y() != float(i))
+            return false;
+      }
+      return true;
+    };
+    SMARTIT_TEST_ASSERT(values, true);
+
+    // copies use the same arena
+    Container copy = containers.back();
+    auto copied = [&]() {
+      return copy.get_allocator() == containers.back().get_allocator() &&
+             copy[5].vector().y() == 5.f;
+    };
+    SMARTIT_TEST_ASSERT(copied, true);
+
+    // all the columns, including those of the nested objects, come from
+    // the first block, whose memory is reused on each event
+    auto arena = [&]() {
+      for (auto &c : containers)
+        if (c.size() != 0 &&
+            (!in_block(&c[0].point().x(), first, 1u << 16) ||
+             !in_block(&c[0].vector().z(), first, 1u << 16)))
+          return false;
+      return a.number_of_blocks() == 1 && base == first;
+    };
+    SMARTIT_TEST_ASSERT(arena, true);
+  }
+}
+
+void test_no_arena() {
+
+  auto throws = []() {
+    smit::vector<smit::point_3d<float>, smit::arena_allocator> v;
+    try {
+      v.resize(10);
+    } catch (std::bad_alloc const &) {
+      return v.empty();
+    }
+    return false;
+  };
+  SMARTIT_TEST_ASSERT(throws, true);
+}
+
+template <class Object>
+using arena_vector = smit::vector<Object, smit::arena_allocator>;
+
+template <class Object>
+using arena_tiled_vector = smit::tiled_vector<Object, 8, smit::arena_allocator>;
+
+int main() {
+
+  smit::test::test_collector coll("test-arena");
+  SMARTIT_TEST_SCOPE_FUNCTION(coll, &test_arena);
+  SMARTIT_TEST_SCOPE_FUNCTION(coll, &test_over_aligned);
+  SMARTIT_TEST_SCOPE_FUNCTION(
+      coll, &test_containers<arena_vector<smit::point_with_vector_3d<float>>>);
+  SMARTIT_TEST_SCOPE_FUNCTION(
+      coll,
+      &test_containers<arena_tiled_vector<smit::point_with_vector_3d<float>>>);
+  SMARTIT_TEST_SCOPE_FUNCTION(coll, &test_no_arena);
+
+  return coll.status();
+}
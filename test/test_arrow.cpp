@@ -0,0 +1,208 @@
+#include <cstring>
+#include <stdexcept>
+
+#include "smartit/arrow.hpp"
+#include "smartit/test.hpp"
+#include "smartit/types.hpp"
+#include "smartit/vector.hpp"
+
+template <typename Type> void test_export() {
+
+  size_t const size = 12;
+
+  smit::vector<smit::point_with_vector_3d<Type>> v(size);
+  for (size_t i = 0; i < size; ++i) {
+    v[i].point().x() = Type(i);
+    v[i].vector().z() = Type(2 * i);
+  }
+
+  ArrowSchema schema;
+  smit::arrow::export_schema<smit::point_with_vector_3d<Type>>(&schema);
+
+  auto check_schema = [&]() {
+    auto const point = schema.children[0];
+    return std::strcmp(schema.format, "+s") == 0 && schema.n_children == 2 &&
+           std::strcmp(point->format, "+s") == 0 &&
+           std::strcmp(point->name, "f0") == 0 && point->n_children == 3 &&
+           std::strcmp(point->children[2]->format,
+                       smit::arrow::format<Type>()) == 0;
+  };
+  SMARTIT_TEST_ASSERT(check_schema, true);
+
+  ArrowArray array;
+  smit::arrow::export_array(v, &array);
+
+  // the buffers refer to the columns of the vector
+  auto zero_copy = [&]() {
+    auto const x = array.children[0]->children[0];
+    auto const z = array.children[1]->children[2];
+    return array.length == std::int64_t(size) && x->n_buffers == 2 &&
+           x->buffers[1] == &v[0].point().x() &&
+           z->buffers[1] == &v[0].vector().z();
+  };
+  SMARTIT_TEST_ASSERT(zero_copy, true);
+
+  // view of the exported array
+  smit::arrow::array_view<smit::point_with_vector_3d<Type>> view(&array,
+                                                                 &schema);
+
+  auto check_view = [&]() {
+    for (size_t i = 0; i < size; ++i)
+      if (view[i].point().x() != Type(i) ||
+          view[i].vector().z() != Type(2 * i) || view[i].point().y() != 0)
+        return false;
+    return view.size() == size && &view[3].point().x() == &v[3].point().x();
+  };
+  SMARTIT_TEST_ASSERT(check_view, true);
+
+  // offsets of the parent arrays apply to the children
+  array.offset = 4;
+  array.length = size - 4;
+  smit::arrow::array_view<smit::point_with_vector_3d<Type>> sliced(&array);
+
+  auto check_offset = [&]() {
+    return sliced.size() == size - 4 && sliced[0].point().x() == Type(4);
+  };
+  SMARTIT_TEST_ASSERT(check_offset, true);
+
+  array.release(&array);
+  schema.release(&schema);
+
+  auto released = [&]() {
+    return array.release == nullptr && schema.release == nullptr;
+  };
+  SMARTIT_TEST_ASSERT(released, true);
+}
+
+template <typename Type> void test_ownership() {
+
+  ArrowArray array;
+  {
+    smit::vector<smit::point_3d<Type>> v(5);
+    v[4].z() = 3;
+    smit::arrow::export_array(std::move(v), &array);
+  }
+
+  // the array keeps the columns alive
+  smit::arrow::array_view<smit::point_3d<Type>> view(&array);
+
+  auto check = [&]() {
+    Type sum = 0;
+    view.for_each_batch([&sum](auto const &b, size_t n) {
+      for (size_t i = 0; i < n; ++i)
+        sum += b.z()[i];
+    });
+    return view.size() == 5 && sum == 3;
+  };
+  SMARTIT_TEST_ASSERT(check, true);
+
+  array.release(&array);
+
+  // children moved out of the array keep the columns alive
+  {
+    smit::vector<smit::point_3d<Type>> v(5);
+    for (size_t i = 0; i < v.size(); ++i)
+      v[i].x() = Type(i + 1);
+    smit::arrow::export_array(std::move(v), &array);
+  }
+
+  ArrowArray x = *array.children[0];
+  array.children[0]->release = nullptr;
+  array.release(&array);
+
+  auto moved = [&x]() {
+    auto const values = static_cast<Type const *>(x.buffers[1]);
+    Type sum = 0;
+    for (std::int64_t i = 0; i < x.length; ++i)
+      sum += values[i];
+    return x.length == 5 && sum == 15;
+  };
+  SMARTIT_TEST_ASSERT(moved, true);
+
+  x.release(&x);
+  SMARTIT_TEST_ASSERT([&x]() { return x.release == nullptr; }, true);
+}
+
+void test_null_count() {
+
+  smit::vector<smit::point_3d<float>> v(3);
+  v[2].y() = 1;
+
+  ArrowArray array;
+  smit::arrow::export_array(v, &array);
+
+  // producers might not compute the number of null values
+  array.null_count = -1;
+  for (std::int64_t i = 0; i < array.n_children; ++i)
+    array.children[i]->null_count = -1;
+
+  smit::arrow::array_view<smit::point_3d<float>> view(&array);
+  SMARTIT_TEST_ASSERT([&view]() { return view[2].y(); }, 1.f);
+
+  // with a validity bitmap, there might be null values
+  unsigned char const bitmap = 0x7;
+  auto const y = array.children[1];
+  y->buffers[0] = &bitmap;
+
+  auto with_bitmap = [&]() {
+    try {
+      smit::arrow::array_view<smit::point_3d<float>> view(&array);
+    } catch (std::invalid_argument const &) {
+      return true;
+    }
+    return false;
+  };
+  SMARTIT_TEST_ASSERT(with_bitmap, true);
+
+  y->buffers[0] = nullptr;
+  array.release(&array);
+}
+
+void test_errors() {
+
+  smit::vector<smit::point_3d<float>> v(3);
+
+  ArrowSchema schema;
+  smit::arrow::export_schema<smit::point_3d<float>>(&schema);
+  ArrowArray array;
+  smit::arrow::export_array(v, &array);
+
+  // the format and the structure must match the object
+  auto wrong_format = [&]() {
+    try {
+      smit::arrow::array_view<smit::point_3d<double>> view(&array, &schema);
+    } catch (std::invalid_argument const &) {
+      return true;
+    }
+    return false;
+  };
+  SMARTIT_TEST_ASSERT(wrong_format, true);
+
+  auto wrong_structure = [&]() {
+    try {
+      smit::arrow::array_view<smit::point_with_vector_3d<float>> view(
+          &array);
+    } catch (std::invalid_argument const &) {
+      return true;
+    }
+    return false;
+  };
+  SMARTIT_TEST_ASSERT(wrong_structure, true);
+
+  array.release(&array);
+  schema.release(&schema);
+}
+
+int main() {
+
+  smit::test::test_collector coll("test-arrow");
+  SMARTIT_TEST_SCOPE_FUNCTION(coll, &test_export<std::int32_t>);
+  SMARTIT_TEST_SCOPE_FUNCTION(coll, &test_export<float>);
+  SMARTIT_TEST_SCOPE_FUNCTION(coll, &test_export<double>);
+  SMARTIT_TEST_SCOPE_FUNCTION(coll, &test_ownership<float>);
+  SMARTIT_TEST_SCOPE_FUNCTION(coll, &test_ownership<double>);
+  SMARTIT_TEST_SCOPE_FUNCTION(coll, &test_null_count);
+  SMARTIT_TEST_SCOPE_FUNCTION(coll, &test_errors);
+
+  return coll.status();
+}
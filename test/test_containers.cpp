@@ -1,3 +1,8 @@
+#include <algorithm>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
 #include "smartit/array.hpp"
 #include "smartit/test.hpp"
 #include "smartit/types.hpp"
@@ -50,6 +55,302 @@ template <typename Type> void test_vector() {
   SMARTIT_TEST_ASSERT(a.size, 20);
 }
 
+template <typename Type> void test_vector_storage() {
+
+  smit::vector<smit::point_3d<Type>> a(10);
+
+  Type i = 0;
+  for (auto it = a.begin(); it != a.end(); ++it, ++i) {
+    it->x() = i;
+    it->y() = 2 * i;
+    it->z() = 3 * i;
+  }
+
+  // columns are aligned to a cache line
+  auto aligned = [&a]() {
+    return reinterpret_cast<std::uintptr_t>(std::get<0>(a)) %
+                   smit::core::cache_line_size ==
+               0 &&
+           reinterpret_cast<std::uintptr_t>(std::get<1>(a)) %
+                   smit::core::cache_line_size ==
+               0 &&
+           reinterpret_cast<std::uintptr_t>(std::get<2>(a)) %
+                   smit::core::cache_line_size ==
+               0;
+  };
+  SMARTIT_TEST_ASSERT(aligned, true);
+
+  // values are preserved when the block is reallocated
+  a.reserve(100);
+  SMARTIT_TEST_ASSERT(a.capacity, 100);
+  SMARTIT_TEST_ASSERT(aligned, true);
+
+  auto check = [](smit::vector<smit::point_3d<Type>> const &v) {
+    Type i = 0;
+    for (auto it = v.begin(); it != v.end(); ++it, ++i)
+      if (it->x() != i || it->y() != 2 * i || it->z() != 3 * i)
+        return false;
+    return true;
+  };
+  SMARTIT_TEST_ASSERT(check, true, a);
+
+  // new elements are initialized
+  a.resize(20);
+  auto initialized = [&a]() {
+    for (auto it = a.cbegin() + 10; it != a.cend(); ++it)
+      if (it->x() != 0 || it->y() != 0 || it->z() != 0)
+        return false;
+    return a.size() == 20;
+  };
+  SMARTIT_TEST_ASSERT(initialized, true);
+
+  a.resize(10);
+
+  // copies do not share the memory block
+  auto b = a;
+  SMARTIT_TEST_ASSERT(check, true, b);
+  b.begin()->x() = 1;
+  SMARTIT_TEST_ASSERT(check, true, a);
+
+  auto c = std::move(b);
+  SMARTIT_TEST_ASSERT(c.size, 10);
+  SMARTIT_TEST_ASSERT(b.size, 0);
+
+  // nested data objects
+  smit::vector<smit::test::two_single_values<Type>> n(5);
+  n.begin()->first().value() = 1;
+  n.reserve(50);
+  SMARTIT_TEST_ASSERT(n.size, 5);
+  SMARTIT_TEST_ASSERT(n.capacity, 50);
+  SMARTIT_TEST_ASSERT(n.begin()->first().value, 1);
+
+  // the columns of nested data objects are stored in the same block, one
+  // after the other
+  auto flat = [&n]() {
+    auto const first = std::get<0>(std::get<0>(n));
+    auto const second = std::get<0>(std::get<1>(n));
+    return second - first ==
+           std::ptrdiff_t(smit::core::_f_cache_lines<Type>(n.capacity()) *
+                          smit::core::cache_line_size / sizeof(Type));
+  };
+  SMARTIT_TEST_ASSERT(flat, true);
+
+  auto m = n;
+  m.resize(10);
+  m.emplace_back(smit::test::single_value<Type>{2},
+                 smit::test::single_value<Type>{3});
+  auto nested = [&m]() {
+    return m.size() == 11 && m[0].first().value() == 1 &&
+           m[5].second().value() == 0 && m[10].first().value() == 2 &&
+           m[10].second().value() == 3;
+  };
+  SMARTIT_TEST_ASSERT(nested, true);
+}
+
+template <typename Type> void test_iterator() {
+
+  smit::vector<smit::point_3d<Type>> a(10);
+
+  for (size_t i = 0; i < a.size(); ++i)
+    a[i].x() = i;
+
+  auto it = a.begin();
+
+  SMARTIT_TEST_ASSERT((it + 4)->x, 4);
+  SMARTIT_TEST_ASSERT((4 + it)->x, 4);
+  SMARTIT_TEST_ASSERT(it[4].x, 4);
+
+  it += 6;
+  SMARTIT_TEST_ASSERT(it->x, 6);
+  SMARTIT_TEST_ASSERT((it - 2)->x, 4);
+  it -= 6;
+  SMARTIT_TEST_ASSERT(it->x, 0);
+
+  auto distance = [&a]() { return a.end() - a.begin(); };
+  SMARTIT_TEST_ASSERT(distance, 10);
+
+  typename smit::vector<smit::point_3d<Type>>::const_iterator cit = a.begin();
+  auto compare = [&]() { return cit == it && cit < a.end(); };
+  SMARTIT_TEST_ASSERT(compare, true);
+
+  // the size of the iterator does not depend on the number of fields
+  auto same_size = []() {
+    return sizeof(typename smit::vector<smit::point_3d<Type>>::iterator) ==
+           sizeof(typename smit::vector<smit::test::single_value<Type>>::
+                      iterator);
+  };
+  SMARTIT_TEST_ASSERT(same_size, true);
+
+  // the iterators return references by value, so the elements are bound
+  // with "auto &&" or "auto", which refer to the container too
+  for (auto &&p : a)
+    p.y() = 1;
+  for (auto p : a)
+    p.z() = 2;
+  std::for_each(a.begin(), a.end(), [](auto &&p) { p.x() += 1; });
+
+  auto bound = [&a]() {
+    for (size_t i = 0; i < a.size(); ++i)
+      if (a[i].x() != Type(i + 1) || a[i].y() != 1 || a[i].z() != 2)
+        return false;
+    return true;
+  };
+  SMARTIT_TEST_ASSERT(bound, true);
+
+  static_assert(!std::is_reference<decltype(*a.begin())>::value,
+                "Iterators must return references by value");
+}
+
+template <typename Type> void test_vector_push_back() {
+
+  smit::vector<smit::point_3d<Type>> a;
+
+  for (size_t i = 0; i < 100; ++i)
+    a.push_back(smit::point_3d<Type>{Type(i), Type(2 * i), Type(3 * i)});
+
+  SMARTIT_TEST_ASSERT(a.size, 100);
+
+  // capacity grows geometrically
+  auto capacity = [&a]() { return a.capacity() >= 100 && a.capacity() < 200; };
+  SMARTIT_TEST_ASSERT(capacity, true);
+
+  for (size_t i = 0; i < 100; ++i)
+    a.emplace_back(Type(i), Type(2 * i), Type(3 * i));
+
+  // copy elements from another vector
+  smit::vector<smit::point_3d<Type>> b;
+  for (auto it = a.cbegin(); it != a.cend(); ++it)
+    b.push_back(*it);
+
+  auto check = [&b]() {
+    for (size_t i = 0; i < b.size(); ++i) {
+      Type j = i % 100;
+      if (b[i].x() != j || b[i].y() != 2 * j || b[i].z() != 3 * j)
+        return false;
+    }
+    return b.size() == 200;
+  };
+  SMARTIT_TEST_ASSERT(check, true);
+
+  SMARTIT_TEST_ASSERT(a.emplace_back(1, 2, 3).z, 3);
+
+  // nested data objects
+  smit::vector<smit::test::two_single_values<Type>> n;
+  for (size_t i = 0; i < 20; ++i)
+    n.emplace_back(smit::test::single_value<Type>{Type(i)},
+                   smit::test::single_value<Type>{Type(i + 1)});
+
+  SMARTIT_TEST_ASSERT(n.size, 20);
+  SMARTIT_TEST_ASSERT(n[10].first().value, 10);
+  SMARTIT_TEST_ASSERT(n[10].second().value, 11);
+}
+
+template <typename Type> void test_vector_push_back_aliased() {
+
+  // the appended element refers to the vector itself, across several
+  // reallocations of the memory block
+  smit::vector<smit::point_3d<Type>> a;
+  a.emplace_back(1, 2, 3);
+  for (size_t i = 0; i < 100; ++i)
+    a.push_back(a[0]);
+
+  for (size_t i = 0; i < 100; ++i)
+    a.emplace_back(a[i].x(), a[i].y(), a[i].z());
+
+  auto check = [&a]() {
+    for (auto it = a.cbegin(); it != a.cend(); ++it)
+      if (it->x() != 1 || it->y() != 2 || it->z() != 3)
+        return false;
+    return a.size() == 201;
+  };
+  SMARTIT_TEST_ASSERT(check, true);
+}
+
+template <typename Type> void test_proxy_reference() {
+
+  smit::vector<smit::point_with_vector_3d<Type>> v(20);
+  for (size_t i = 0; i < v.size(); ++i) {
+    v[i].point().x() = Type((i * 7) % 20);
+    v[i].vector().x() = 2 * v[i].point().x();
+  }
+
+  // the fields of each element are moved together
+  auto consistent = [&v]() {
+    for (auto it = v.cbegin(); it != v.cend(); ++it)
+      if (it->vector().x() != 2 * it->point().x())
+        return false;
+    return true;
+  };
+
+  // assignment and swap operate on the values
+  v[0] = v[1];
+  SMARTIT_TEST_ASSERT([&v]() { return v[0].point().x(); }, Type(7));
+  v[0].point().x() = 0;
+  SMARTIT_TEST_ASSERT([&v]() { return v[1].point().x(); }, Type(7));
+  v[0].vector().x() = 0;
+
+  swap(v[0], v[1]);
+  SMARTIT_TEST_ASSERT([&v]() { return v[0].point().x(); }, Type(7));
+  SMARTIT_TEST_ASSERT([&v]() { return v[1].point().x(); }, Type(0));
+
+  // conversion to the value type
+  smit::point_with_vector_3d<Type> value = v[0];
+  v[2] = value;
+  SMARTIT_TEST_ASSERT([&v]() { return v[2].vector().x(); }, Type(14));
+  v[2].point() = v[3].point();
+  v[2].vector() = v[3].vector();
+
+  auto by_x = [](auto const &a, auto const &b) {
+    return a.point().x() < b.point().x();
+  };
+
+  std::sort(v.begin(), v.end(), by_x);
+
+  auto sorted = [&]() {
+    return std::is_sorted(v.cbegin(), v.cend(), by_x) && consistent();
+  };
+  SMARTIT_TEST_ASSERT(sorted, true);
+
+  std::reverse(v.begin(), v.end());
+  std::rotate(v.begin(), v.begin() + 5, v.end());
+  std::nth_element(v.begin(), v.begin() + 10, v.end(), by_x);
+
+  auto nth = [&]() {
+    for (size_t i = 0; i < v.size(); ++i)
+      if ((i < 10 && v[i].point().x() > v[10].point().x()) ||
+          (i > 10 && v[i].point().x() < v[10].point().x()))
+        return false;
+    return consistent();
+  };
+  SMARTIT_TEST_ASSERT(nth, true);
+
+  auto even = [](auto const &p) { return int(p.point().x()) % 2 == 0; };
+
+  auto const evens = std::count_if(v.cbegin(), v.cend(), even);
+
+  auto middle = std::stable_partition(v.begin(), v.end(), even);
+  auto partitioned = [&]() {
+    return std::is_partitioned(v.cbegin(), v.cend(), even) &&
+           middle - v.begin() == evens && consistent();
+  };
+  SMARTIT_TEST_ASSERT(partitioned, true);
+
+  auto end = std::remove_if(v.begin(), v.end(), even);
+  auto removed = [&]() {
+    for (auto it = v.begin(); it != end; ++it)
+      if (even(*it))
+        return false;
+    return end - v.begin() == 20 - evens && consistent();
+  };
+  SMARTIT_TEST_ASSERT(removed, true);
+
+  // iterator functions
+  iter_swap(v.begin(), v.begin() + 1);
+  smit::point_with_vector_3d<Type> moved = iter_move(v.begin());
+  SMARTIT_TEST_ASSERT([&]() { return moved.point().x(); },
+                      v[0].point().x());
+}
+
 int main() {
 
   smit::test::test_collector acoll("test-array");
@@ -61,6 +362,21 @@ int main() {
   SMARTIT_TEST_SCOPE_FUNCTION(vcoll, &test_vector<int>);
   SMARTIT_TEST_SCOPE_FUNCTION(vcoll, &test_vector<float>);
   SMARTIT_TEST_SCOPE_FUNCTION(vcoll, &test_vector<double>);
+  SMARTIT_TEST_SCOPE_FUNCTION(vcoll, &test_vector_storage<int>);
+  SMARTIT_TEST_SCOPE_FUNCTION(vcoll, &test_vector_storage<float>);
+  SMARTIT_TEST_SCOPE_FUNCTION(vcoll, &test_vector_storage<double>);
+  SMARTIT_TEST_SCOPE_FUNCTION(vcoll, &test_iterator<int>);
+  SMARTIT_TEST_SCOPE_FUNCTION(vcoll, &test_iterator<float>);
+  SMARTIT_TEST_SCOPE_FUNCTION(vcoll, &test_iterator<double>);
+  SMARTIT_TEST_SCOPE_FUNCTION(vcoll, &test_vector_push_back<int>);
+  SMARTIT_TEST_SCOPE_FUNCTION(vcoll, &test_vector_push_back<float>);
+  SMARTIT_TEST_SCOPE_FUNCTION(vcoll, &test_vector_push_back<double>);
+  SMARTIT_TEST_SCOPE_FUNCTION(vcoll, &test_vector_push_back_aliased<int>);
+  SMARTIT_TEST_SCOPE_FUNCTION(vcoll, &test_vector_push_back_aliased<float>);
+  SMARTIT_TEST_SCOPE_FUNCTION(vcoll, &test_vector_push_back_aliased<double>);
+  SMARTIT_TEST_SCOPE_FUNCTION(vcoll, &test_proxy_reference<int>);
+  SMARTIT_TEST_SCOPE_FUNCTION(vcoll, &test_proxy_reference<float>);
+  SMARTIT_TEST_SCOPE_FUNCTION(vcoll, &test_proxy_reference<double>);
 
   return smit::test::combined_status(vcoll.status(), vcoll.status());
 }
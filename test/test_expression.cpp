@@ -0,0 +1,155 @@
+#include "smartit/array.hpp"
+#include "smartit/expression.hpp"
+#include "smartit/test.hpp"
+#include "smartit/types.hpp"
+#include "smartit/vector.hpp"
+
+#include <stdexcept>
+
+template <typename Type> void test_arithmetic() {
+
+  // the size is not a multiple of the number of lanes
+  size_t const size = 23;
+
+  smit::vector<smit::point_3d<Type>> a(size), b(size), out;
+
+  for (size_t i = 0; i < size; ++i) {
+    a[i].x() = Type(i);
+    a[i].y() = Type(2 * i);
+    a[i].z() = Type(3 * i);
+    b[i].x() = 1;
+    b[i].y() = 2;
+    b[i].z() = 3;
+  }
+
+  Type const s = 2;
+
+  out = a + s * b;
+
+  auto check = [&]() {
+    for (size_t i = 0; i < size; ++i)
+      if (out[i].x() != Type(i + 2) || out[i].y() != Type(2 * i + 4) ||
+          out[i].z() != Type(3 * i + 6))
+        return false;
+    return out.size() == size;
+  };
+  SMARTIT_TEST_ASSERT(check, true);
+
+  // the container can be an operand of the expression
+  out = -(out - a) / 2 + out;
+
+  auto inplace = [&]() {
+    for (size_t i = 0; i < size; ++i)
+      if (out[i].x() != Type(i + 1) || out[i].y() != Type(2 * i + 2) ||
+          out[i].z() != Type(3 * i + 3))
+        return false;
+    return true;
+  };
+  SMARTIT_TEST_ASSERT(inplace, true);
+
+  // nested data objects
+  smit::vector<smit::test::two_single_values<Type>> n(size);
+  for (size_t i = 0; i < size; ++i) {
+    n[i].first().value() = Type(i);
+    n[i].second().value() = Type(1);
+  }
+
+  smit::vector<smit::test::two_single_values<Type>> m = n * n + 1;
+
+  auto nested = [&]() {
+    for (size_t i = 0; i < size; ++i)
+      if (m[i].first().value() != Type(i * i + 1) ||
+          m[i].second().value() != Type(2))
+        return false;
+    return m.size() == size;
+  };
+  SMARTIT_TEST_ASSERT(nested, true);
+}
+
+template <typename Type> void test_size_mismatch() {
+
+  smit::vector<smit::point_3d<Type>> a(1000), b(10), out;
+
+  auto throws = [&]() {
+    try {
+      out = a + b;
+    } catch (std::length_error const &) {
+      return out.empty();
+    }
+    return false;
+  };
+  SMARTIT_TEST_ASSERT(throws, true);
+
+  // nested expressions are also checked
+  auto nested = [&]() {
+    try {
+      out = Type(2) * a - (b + a);
+    } catch (std::length_error const &) {
+      return true;
+    }
+    return false;
+  };
+  SMARTIT_TEST_ASSERT(nested, true);
+
+  // scalars do not have a size, and empty containers can be combined
+  smit::vector<smit::point_3d<Type>> e;
+  out = Type(2) * e + e;
+  SMARTIT_TEST_ASSERT(out.size, 0);
+}
+
+template <typename Type> void test_functions() {
+
+  smit::array<smit::point_3d<Type>, 10> a, b, out;
+
+  for (size_t i = 0; i < a.size(); ++i) {
+    a[i].x() = 1;
+    a[i].y() = 0;
+    a[i].z() = 0;
+    b[i].x() = 0;
+    b[i].y() = Type(i);
+    b[i].z() = 0;
+  }
+
+  out = cross(a, b);
+
+  auto check = [&]() {
+    for (size_t i = 0; i < out.size(); ++i)
+      if (out[i].x() != 0 || out[i].y() != 0 || out[i].z() != Type(i))
+        return false;
+    return true;
+  };
+  SMARTIT_TEST_ASSERT(check, true);
+
+  // user-defined functions are called on batches
+  out = smit::make_expression(
+      [](auto const &p, auto const &q) {
+        auto r = p;
+        r.x() = q.mod2();
+        return r;
+      },
+      a, b);
+
+  auto custom = [&]() {
+    for (size_t i = 0; i < out.size(); ++i)
+      if (out[i].x() != Type(i * i) || out[i].y() != 0 || out[i].z() != 0)
+        return false;
+    return true;
+  };
+  SMARTIT_TEST_ASSERT(custom, true);
+}
+
+int main() {
+
+  smit::test::test_collector coll("test-expression");
+  SMARTIT_TEST_SCOPE_FUNCTION(coll, &test_arithmetic<int>);
+  SMARTIT_TEST_SCOPE_FUNCTION(coll, &test_arithmetic<float>);
+  SMARTIT_TEST_SCOPE_FUNCTION(coll, &test_arithmetic<double>);
+  SMARTIT_TEST_SCOPE_FUNCTION(coll, &test_size_mismatch<int>);
+  SMARTIT_TEST_SCOPE_FUNCTION(coll, &test_size_mismatch<float>);
+  SMARTIT_TEST_SCOPE_FUNCTION(coll, &test_size_mismatch<double>);
+  SMARTIT_TEST_SCOPE_FUNCTION(coll, &test_functions<int>);
+  SMARTIT_TEST_SCOPE_FUNCTION(coll, &test_functions<float>);
+  SMARTIT_TEST_SCOPE_FUNCTION(coll, &test_functions<double>);
+
+  return coll.status();
+}
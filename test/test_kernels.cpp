@@ -0,0 +1,144 @@
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "smartit/array.hpp"
+#include "smartit/kernels.hpp"
+#include "smartit/test.hpp"
+#include "smartit/vector.hpp"
+
+/// Whether two values are equal up to a relative tolerance
+template <class Type> bool close(Type a, Type b) {
+  return std::abs(a - b) <=
+         16 * std::numeric_limits<Type>::epsilon() *
+             std::max(Type(1), std::max(std::abs(a), std::abs(b)));
+}
+
+template <typename Type> void test_acos() {
+
+  smit::simd::pack<Type, 4> p;
+
+  auto check = [&p]() {
+    for (int i = -1000; i + 3 <= 1000; i += 4) {
+      Type const values[] = {Type(i) / 1000, Type(i + 1) / 1000,
+                             Type(i + 2) / 1000, Type(i + 3) / 1000};
+      p = smit::simd::pack<Type, 4>::load(values);
+      auto const r = smit::simd::acos(p);
+      for (size_t j = 0; j < 4; ++j)
+        if (!close(r[j], Type(std::acos(values[j]))))
+          return false;
+    }
+    return true;
+  };
+  SMARTIT_TEST_ASSERT(check, true);
+}
+
+template <typename Type> void test_vector_kernels() {
+
+  // the size is not a multiple of the number of lanes
+  size_t const size = 103;
+
+  smit::vector<smit::point_3d<Type>> a(size), b(size);
+
+  for (size_t i = 0; i < size; ++i) {
+    a[i].x() = Type(i) + 1;
+    a[i].y() = Type(i % 7) - 3;
+    a[i].z() = Type(i % 5) - 2;
+    b[i].x() = Type(i % 3) - 1;
+    b[i].y() = Type(2 * i);
+    b[i].z() = 1;
+  }
+
+  std::vector<Type> out(size);
+
+  auto check_scalar = [&](auto reference) {
+    for (size_t i = 0; i < size; ++i)
+      if (!close(out[i], Type(reference(i))))
+        return false;
+    return true;
+  };
+
+  smit::kernels::dot(a, b, out.data());
+  auto dot = [&]() {
+    return check_scalar([&](size_t i) { return smit::dot(a[i], b[i]); });
+  };
+  SMARTIT_TEST_ASSERT(dot, true);
+
+  smit::kernels::norm(a, out.data());
+  auto norm = [&]() {
+    return check_scalar([&](size_t i) { return std::sqrt(a[i].mod2()); });
+  };
+  SMARTIT_TEST_ASSERT(norm, true);
+
+  smit::kernels::phi(a, out.data());
+  auto phi = [&]() {
+    return check_scalar([&](size_t i) { return a[i].phi(); });
+  };
+  SMARTIT_TEST_ASSERT(phi, true);
+
+  smit::kernels::theta(a, out.data());
+  auto theta = [&]() {
+    return check_scalar([&](size_t i) { return a[i].theta(); });
+  };
+  SMARTIT_TEST_ASSERT(theta, true);
+
+  smit::vector<smit::point_3d<Type>> c(size);
+
+  smit::kernels::cross(a, b, c);
+  auto cross = [&]() {
+    for (size_t i = 0; i < size; ++i) {
+      auto const r = smit::cross(a[i], b[i]);
+      if (c[i].x() != r.x() || c[i].y() != r.y() || c[i].z() != r.z())
+        return false;
+    }
+    return true;
+  };
+  SMARTIT_TEST_ASSERT(cross, true);
+
+  smit::kernels::normalize(a, c);
+  smit::kernels::normalize(a);
+  smit::kernels::mod2(a, out.data());
+  auto normalize = [&]() {
+    for (size_t i = 0; i < size; ++i)
+      if (!close(out[i], Type(1)) || c[i].x() != a[i].x() ||
+          c[i].y() != a[i].y() || c[i].z() != a[i].z())
+        return false;
+    return true;
+  };
+  SMARTIT_TEST_ASSERT(normalize, true);
+}
+
+template <typename Type> void test_array_kernels() {
+
+  smit::array<smit::point_3d<Type>, 5> a;
+
+  for (size_t i = 0; i < a.size(); ++i) {
+    a[i].x() = 0;
+    a[i].y() = 0;
+    a[i].z() = Type(i) + 1;
+  }
+
+  std::vector<Type> out(a.size());
+
+  smit::kernels::theta(a, out.data());
+  auto theta = [&]() {
+    for (auto v : out)
+      if (v != 0)
+        return false;
+    return true;
+  };
+  SMARTIT_TEST_ASSERT(theta, true);
+}
+
+int main() {
+
+  smit::test::test_collector coll("test-kernels");
+  SMARTIT_TEST_SCOPE_FUNCTION(coll, &test_acos<float>);
+  SMARTIT_TEST_SCOPE_FUNCTION(coll, &test_acos<double>);
+  SMARTIT_TEST_SCOPE_FUNCTION(coll, &test_vector_kernels<float>);
+  SMARTIT_TEST_SCOPE_FUNCTION(coll, &test_vector_kernels<double>);
+  SMARTIT_TEST_SCOPE_FUNCTION(coll, &test_array_kernels<float>);
+  SMARTIT_TEST_SCOPE_FUNCTION(coll, &test_array_kernels<double>);
+
+  return coll.status();
+}
@@ -0,0 +1,90 @@
+#include "smartit/algorithm.hpp"
+#include "smartit/container.hpp"
+#include "smartit/kernels.hpp"
+#include "smartit/test.hpp"
+#include "smartit/types.hpp"
+
+/// The same code is used for all the layouts
+template <class Container> void fill(Container &c) {
+  for (auto it = c.begin(); it != c.end(); ++it) {
+    auto const i = it - c.begin();
+    it->point().x() = float(i);
+    it->point().y() = float(2 * i);
+    it->point().z() = 0.f;
+    it->vector().x() = 1.f;
+    it->vector().y() = 0.f;
+    it->vector().z() = 0.f;
+  }
+}
+
+template <class Layout> void test_layout() {
+
+  size_t const size = 29;
+
+  smit::container<smit::point_with_vector_3d<float>, Layout> c(size);
+
+  fill(c);
+
+  // move the points along the vectors
+  smit::for_each(smit::execution::seq, c.begin(), c.end(), [](auto e) {
+    e.point().x() += e.vector().x();
+    e.point().z() = e.point().y();
+  });
+
+  auto check = [&]() {
+    for (size_t i = 0; i < size; ++i)
+      if (c[i].point().x() != float(i + 1) ||
+          c[i].point().z() != float(2 * i) || c[i].vector().x() != 1.f)
+        return false;
+    return c.size() == size;
+  };
+  SMARTIT_TEST_ASSERT(check, true);
+
+  // batches and expressions
+  smit::container<smit::point_3d<float>, Layout> p(size), q;
+  for (size_t i = 0; i < size; ++i) {
+    p[i].x() = float(i);
+    p[i].y() = 1.f;
+    p[i].z() = 0.f;
+  }
+
+  q = p + p;
+
+  std::vector<float> m(size);
+  smit::kernels::mod2(q, m.data());
+
+  auto batches = [&]() {
+    for (size_t i = 0; i < size; ++i)
+      if (m[i] != float(4 * i * i + 4))
+        return false;
+    return true;
+  };
+  SMARTIT_TEST_ASSERT(batches, true);
+}
+
+void test_aos() {
+
+  smit::container<smit::point_3d<float>, smit::layout::aos> c(10);
+
+  // the fields of each element are contiguous
+  auto contiguous = [&]() {
+    for (size_t i = 0; i < c.size(); ++i)
+      if (&c[i].y() != &c[i].x() + 1 || &c[i].z() != &c[i].x() + 2 ||
+          (i != 0 && &c[i].x() != &c[i - 1].z() + 1))
+        return false;
+    return true;
+  };
+  SMARTIT_TEST_ASSERT(contiguous, true);
+}
+
+int main() {
+
+  smit::test::test_collector coll("test-layout");
+  SMARTIT_TEST_SCOPE_FUNCTION(coll, &test_layout<smit::layout::soa>);
+  SMARTIT_TEST_SCOPE_FUNCTION(coll, &test_layout<smit::layout::aos>);
+  SMARTIT_TEST_SCOPE_FUNCTION(coll, &test_layout<smit::layout::aosoa<4>>);
+  SMARTIT_TEST_SCOPE_FUNCTION(coll, &test_layout<smit::layout::aosoa<16>>);
+  SMARTIT_TEST_SCOPE_FUNCTION(coll, &test_aos);
+
+  return coll.status();
+}
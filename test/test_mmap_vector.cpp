@@ -0,0 +1,155 @@
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+
+#include <unistd.h>
+
+#include "smartit/mmap_vector.hpp"
+#include "smartit/test.hpp"
+#include "smartit/types.hpp"
+#include "smartit/vector.hpp"
+
+/// Path to a temporary file for the tests
+std::string temporary_path(std::string const &name) {
+  return "/tmp/smartit-" + name + "-" + std::to_string(::getpid()) + ".smit";
+}
+
+template <typename Type> void test_mmap_vector() {
+
+  size_t const size = 37;
+
+  auto const path = temporary_path("mmap-vector");
+
+  smit::vector<smit::point_with_vector_3d<Type>> v(size);
+  for (size_t i = 0; i < size; ++i) {
+    v[i].point().x() = Type(i);
+    v[i].vector().z() = Type(2 * i);
+  }
+
+  // copy the elements of a vector to a file
+  {
+    smit::mmap_vector<smit::point_with_vector_3d<Type>> m(path, v);
+    m.flush();
+  }
+
+  auto check = [&](auto const &m) {
+    for (size_t i = 0; i < size; ++i)
+      if (m[i].point().x() != Type(i) || m[i].point().y() != 0 ||
+          m[i].vector().z() != Type(2 * i))
+        return false;
+    return m.size() == size;
+  };
+
+  // read-only mode
+  {
+    smit::mmap_vector<smit::point_with_vector_3d<Type>,
+                      smit::mmap_mode::read_only>
+        m(path);
+    SMARTIT_TEST_ASSERT(check, true, m);
+  }
+
+  // changes are stored in the file in read-write mode
+  {
+    smit::mmap_vector<smit::point_with_vector_3d<Type>> m(path);
+    m.for_each_batch([](auto &b) { b.point().y() = b.point().x(); });
+  }
+  {
+    smit::mmap_vector<smit::point_with_vector_3d<Type>> const m(path);
+    auto modified = [&]() {
+      for (size_t i = 0; i < size; ++i)
+        if (m[i].point().y() != Type(i))
+          return false;
+      return true;
+    };
+    SMARTIT_TEST_ASSERT(modified, true);
+  }
+
+  // new files are filled with zeros
+  {
+    smit::mmap_vector<smit::point_3d<Type>> m(path, 10);
+    auto zero = [&]() {
+      for (auto p : m)
+        if (p.x() != 0 || p.y() != 0 || p.z() != 0)
+          return false;
+      return m.size() == 10;
+    };
+    SMARTIT_TEST_ASSERT(zero, true);
+  }
+
+  std::remove(path.c_str());
+}
+
+void test_errors() {
+
+  auto const path = temporary_path("mmap-errors");
+
+  { smit::mmap_vector<smit::point_3d<float>> m(path, 4); }
+
+  // the fields of the object must match those in the file
+  auto wrong_type = [&]() {
+    try {
+      smit::mmap_vector<smit::point_3d<double>> m(path);
+    } catch (std::runtime_error const &) {
+      return true;
+    }
+    return false;
+  };
+  SMARTIT_TEST_ASSERT(wrong_type, true);
+
+  auto wrong_fields = [&]() {
+    try {
+      smit::mmap_vector<smit::point_with_vector_3d<float>> m(path);
+    } catch (std::runtime_error const &) {
+      return true;
+    }
+    return false;
+  };
+  SMARTIT_TEST_ASSERT(wrong_fields, true);
+
+  // a corrupt number of elements, so the size of the columns overflows
+  {
+    std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+    file.seekp(offsetof(smit::core::__mmap_header, size));
+    std::uint64_t const size = (std::uint64_t{1} << 62) + 1;
+    file.write(reinterpret_cast<char const *>(&size), sizeof(size));
+  }
+
+  auto overflow = [&]() {
+    try {
+      smit::mmap_vector<smit::point_3d<float>, smit::mmap_mode::read_only> m(
+          path);
+    } catch (std::runtime_error const &) {
+      return true;
+    }
+    return false;
+  };
+  SMARTIT_TEST_ASSERT(overflow, true);
+
+  std::remove(path.c_str());
+
+  auto missing = [&]() {
+    try {
+      smit::mmap_vector<smit::point_3d<float>, smit::mmap_mode::read_only> m(
+          path);
+    } catch (std::system_error const &) {
+      return true;
+    }
+    return false;
+  };
+  SMARTIT_TEST_ASSERT(missing, true);
+}
+
+int main() {
+
+  smit::test::test_collector coll("test-mmap-vector");
+  SMARTIT_TEST_SCOPE_FUNCTION(coll, &test_mmap_vector<int>);
+  SMARTIT_TEST_SCOPE_FUNCTION(coll, &test_mmap_vector<float>);
+  SMARTIT_TEST_SCOPE_FUNCTION(coll, &test_mmap_vector<double>);
+  SMARTIT_TEST_SCOPE_FUNCTION(coll, &test_errors);
+
+  return coll.status();
+}
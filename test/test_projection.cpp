@@ -0,0 +1,105 @@
+#include <vector>
+
+#include "smartit/projection.hpp"
+#include "smartit/test.hpp"
+#include "smartit/tiled_vector.hpp"
+#include "smartit/types.hpp"
+#include "smartit/vector.hpp"
+
+template <typename Type> void test_projection() {
+
+  size_t const size = 19;
+
+  smit::vector<smit::point_3d<Type>> v(size);
+
+  auto xy = smit::project<0, 1>(v);
+
+  for (auto it = xy.begin(); it != xy.end(); ++it) {
+    it->x() = Type(it - xy.begin());
+    it->y() = 2 * it->x();
+  }
+
+  // the excluded fields are not modified
+  auto check = [&]() {
+    for (size_t i = 0; i < size; ++i)
+      if (v[i].x() != Type(i) || v[i].y() != Type(2 * i) || v[i].z() != 0)
+        return false;
+    return xy.size() == size;
+  };
+  SMARTIT_TEST_ASSERT(check, true);
+
+  // fields are selected by position
+  auto const &cv = v;
+  auto z = smit::project<2>(v);
+  auto x = smit::project<0>(cv);
+  for (size_t i = 0; i < size; ++i)
+    z[i].z() = x[i].x() + 1;
+
+  auto selected = [&]() {
+    for (size_t i = 0; i < size; ++i)
+      if (v[i].z() != Type(i + 1))
+        return false;
+    return true;
+  };
+  SMARTIT_TEST_ASSERT(selected, true);
+
+  // the view follows the container on reallocation
+  v.resize(2 * size);
+  auto follow = [&]() {
+    return xy.size() == 2 * size && xy[size - 1].x() == Type(size - 1) &&
+           xy[2 * size - 1].x() == 0;
+  };
+  SMARTIT_TEST_ASSERT(follow, true);
+}
+
+template <typename Type> void test_batches() {
+
+  size_t const size = 21;
+
+  smit::tiled_vector<smit::point_with_vector_3d<Type>, 4> v(size);
+
+  // nested data objects are fully selected
+  auto vectors = smit::project<1>(v);
+  for (auto e : vectors) {
+    e.vector().x() = 1;
+    e.vector().y() = 2;
+  }
+
+  vectors.for_each_batch([](auto &b) { b.vector().z() = b.vector().mod2(); });
+
+  auto check = [&]() {
+    for (size_t i = 0; i < size; ++i)
+      if (v[i].vector().z() != 5 || v[i].point().x() != 0)
+        return false;
+    return true;
+  };
+  SMARTIT_TEST_ASSERT(check, true);
+
+  smit::vector<smit::point_3d<Type>> p(size);
+  for (size_t i = 0; i < size; ++i) {
+    p[i].x() = Type(i);
+    p[i].z() = 1;
+  }
+
+  smit::project<0, 2>(p).for_each_batch([](auto &b) { b.z() += b.x(); });
+
+  auto batches = [&]() {
+    for (size_t i = 0; i < size; ++i)
+      if (p[i].z() != Type(i + 1) || p[i].y() != 0)
+        return false;
+    return true;
+  };
+  SMARTIT_TEST_ASSERT(batches, true);
+}
+
+int main() {
+
+  smit::test::test_collector coll("test-projection");
+  SMARTIT_TEST_SCOPE_FUNCTION(coll, &test_projection<int>);
+  SMARTIT_TEST_SCOPE_FUNCTION(coll, &test_projection<float>);
+  SMARTIT_TEST_SCOPE_FUNCTION(coll, &test_projection<double>);
+  SMARTIT_TEST_SCOPE_FUNCTION(coll, &test_batches<float>);
+  SMARTIT_TEST_SCOPE_FUNCTION(coll, &test_batches<double>);
+
+  return coll.status();
+}
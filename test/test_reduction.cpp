@@ -0,0 +1,185 @@
+#include <cmath>
+#include <limits>
+#include <type_traits>
+
+#include "smartit/array.hpp"
+#include "smartit/execution.hpp"
+#include "smartit/reduction.hpp"
+#include "smartit/test.hpp"
+#include "smartit/types.hpp"
+#include "smartit/vector.hpp"
+
+template <typename Type, class Policy>
+void check_reductions(Policy const &policy) {
+
+  // several chunks for the parallel policies, and a tail in the last pack
+  size_t const size = 3 * smit::core::parallel_grain + 7;
+
+  smit::vector<smit::point_3d<Type>> v(size);
+  for (size_t i = 0; i < size; ++i) {
+    v[i].x() = Type(1);
+    v[i].y() = Type(i % 10);
+    v[i].z() = Type(int(i % 7) - 3);
+  }
+
+  // field-wise over the whole object
+  auto const s = smit::sum(policy, v);
+  SMARTIT_TEST_ASSERT([&s]() { return s.x(); }, Type(size));
+  // the values -3, ..., 3 repeat, with -3, ..., 1 left over
+  SMARTIT_TEST_ASSERT([&s]() { return s.z(); }, Type(-5));
+
+  // a single field
+  auto const y = smit::sum<1>(policy, v);
+  static_assert(std::is_same<std::decay_t<decltype(y)>, Type>::value,
+                "The sum of a field must have its type");
+  size_t const tail = size % 10;
+  SMARTIT_TEST_ASSERT([&y]() { return y; },
+                      Type(45 * (size / 10) + tail * (tail - 1) / 2));
+
+  auto const lo = smit::min(policy, v);
+  auto const hi = smit::max<2>(policy, v);
+  SMARTIT_TEST_ASSERT([&lo]() { return lo.y(); }, Type(0));
+  SMARTIT_TEST_ASSERT([&lo]() { return lo.z(); }, Type(-3));
+  SMARTIT_TEST_ASSERT([&hi]() { return hi; }, Type(3));
+
+  // the extrema are found in any position
+  v[size - 1].y() = Type(-5);
+  v[size / 2].y() = Type(50);
+
+  auto const mm = smit::minmax<1>(policy, v);
+  SMARTIT_TEST_ASSERT([&mm]() { return mm.first; }, Type(-5));
+  SMARTIT_TEST_ASSERT([&mm]() { return mm.second; }, Type(50));
+
+  auto const mv = smit::mean_var<2>(policy, v);
+  auto moments = [&mv, size]() {
+    double mean = 0, var = 0;
+    for (size_t i = 0; i < size; ++i)
+      mean += int(i % 7) - 3;
+    mean /= size;
+    for (size_t i = 0; i < size; ++i)
+      var += (int(i % 7) - 3 - mean) * (int(i % 7) - 3 - mean);
+    var /= size;
+    return std::abs(mv.first - mean) < 1e-6 &&
+           std::abs(mv.second - var) < 1e-4;
+  };
+  SMARTIT_TEST_ASSERT(moments, true);
+}
+
+template <typename Type> void test_reductions() {
+  check_reductions<Type>(smit::execution::seq);
+  check_reductions<Type>(smit::execution::par);
+}
+
+void test_summation() {
+
+  // values whose sum loses precision in single precision
+  size_t const size = 1u << 20;
+
+  smit::vector<smit::point_3d<float>> v(size);
+  for (size_t i = 0; i < size; ++i) {
+    v[i].x() = 0.1f;
+    v[i].y() = i == 0 ? 1e8f : 1.f;
+    v[i].z() = 0.f;
+  }
+
+  double const exact = 0.1f * double(size);
+
+  auto close = [exact](float s, double tolerance) {
+    return std::abs(s - exact) < tolerance * exact;
+  };
+
+  SMARTIT_TEST_ASSERT(
+      [&]() { return close(smit::sum<0>(v, smit::summation::kahan), 1e-7); },
+      true);
+  SMARTIT_TEST_ASSERT(
+      [&]() {
+        return close(smit::sum<0>(v, smit::summation::pairwise), 1e-6);
+      },
+      true);
+  SMARTIT_TEST_ASSERT(
+      [&]() {
+        return close(smit::sum<0>(smit::execution::par, v,
+                                  smit::summation::kahan),
+                     1e-7);
+      },
+      true);
+
+  // the small values are kept next to a large one
+  SMARTIT_TEST_ASSERT(
+      [&]() {
+        return std::abs(smit::sum<1>(v, smit::summation::kahan) -
+                        (1e8 + double(size - 1))) <= 8;
+      },
+      true);
+}
+
+template <typename Type> void test_objects() {
+
+  // centroid of points in an array, and nested data objects
+  smit::array<smit::point_with_vector_3d<Type>, 10> a;
+  for (size_t i = 0; i < a.size(); ++i) {
+    a[i].point().x() = Type(i);
+    a[i].point().y() = Type(2 * i);
+    a[i].point().z() = Type(4);
+    a[i].vector().x() = Type(10 - i);
+  }
+
+  // the centroid of integral points has floating point coordinates
+  auto const centroid = smit::mean_var<0>(a).first;
+  static_assert(std::is_floating_point<
+                    std::decay_t<decltype(centroid.x())>>::value,
+                "Integral fields must have a floating point mean");
+  SMARTIT_TEST_ASSERT([&centroid]() { return centroid.x(); }, 4.5);
+  SMARTIT_TEST_ASSERT([&centroid]() { return centroid.y(); }, 9);
+  SMARTIT_TEST_ASSERT([&centroid]() { return centroid.z(); }, 4);
+
+  // whole objects give the same moments as their fields
+  smit::vector<smit::point_3d<Type>> p(2);
+  p[0].x() = Type(1);
+  p[1].x() = Type(2);
+  auto const mv = smit::mean_var(p);
+  SMARTIT_TEST_ASSERT([&mv]() { return mv.first.x(); }, 1.5);
+  SMARTIT_TEST_ASSERT([&mv]() { return mv.second.x(); }, 0.25);
+  SMARTIT_TEST_ASSERT([&mv]() { return mv.first.y(); }, 0);
+
+  auto const x = smit::mean_var<0, 0>(a);
+  static_assert(std::is_floating_point<decltype(x.first)>::value,
+                "Integral values must have a floating point mean");
+  SMARTIT_TEST_ASSERT([&x]() { return x.first; }, 4.5);
+  SMARTIT_TEST_ASSERT([&x]() { return x.second; }, 8.25);
+
+  auto const hi = smit::max(a);
+  SMARTIT_TEST_ASSERT([&hi]() { return hi.point().y(); }, Type(18));
+  SMARTIT_TEST_ASSERT([&hi]() { return hi.vector().x(); }, Type(10));
+
+  // empty containers give the identities
+  smit::vector<smit::point_3d<Type>> e;
+  SMARTIT_TEST_ASSERT([&e]() { return smit::sum<0>(e); }, Type(0));
+  Type const highest = std::numeric_limits<Type>::has_infinity
+                           ? std::numeric_limits<Type>::infinity()
+                           : std::numeric_limits<Type>::max();
+  SMARTIT_TEST_ASSERT([&e]() { return smit::min<0>(e); }, highest);
+
+  // and NaN moments
+  auto const empty = [&e]() {
+    auto const m = smit::mean_var(e);
+    auto const x = smit::mean_var<1>(smit::execution::par, e);
+    return std::isnan(m.first.x()) && std::isnan(m.second.z()) &&
+           std::isnan(x.first) && std::isnan(x.second);
+  };
+  SMARTIT_TEST_ASSERT(empty, true);
+}
+
+int main() {
+
+  smit::test::test_collector coll("test-reduction");
+  SMARTIT_TEST_SCOPE_FUNCTION(coll, &test_reductions<int>);
+  SMARTIT_TEST_SCOPE_FUNCTION(coll, &test_reductions<float>);
+  SMARTIT_TEST_SCOPE_FUNCTION(coll, &test_reductions<double>);
+  SMARTIT_TEST_SCOPE_FUNCTION(coll, &test_summation);
+  SMARTIT_TEST_SCOPE_FUNCTION(coll, &test_objects<int>);
+  SMARTIT_TEST_SCOPE_FUNCTION(coll, &test_objects<float>);
+  SMARTIT_TEST_SCOPE_FUNCTION(coll, &test_objects<double>);
+
+  return coll.status();
+}
@@ -0,0 +1,205 @@
+#include <cmath>
+#include <cstdint>
+
+#include "smartit/array.hpp"
+#include "smartit/simd.hpp"
+#include "smartit/test.hpp"
+#include "smartit/types.hpp"
+#include "smartit/vector.hpp"
+
+template <typename Type> void test_pack() {
+
+  using pack_type = smit::simd::pack<Type, 4>;
+
+  Type const values[] = {1, 4, 9, 16};
+
+  auto p = pack_type::load(values);
+  auto q = pack_type(2);
+
+  auto sum = [&]() { return smit::simd::sum(p + q); };
+  SMARTIT_TEST_ASSERT(sum, 38);
+
+  auto product = [&]() { return (p * q)[3]; };
+  SMARTIT_TEST_ASSERT(product, 32);
+
+  auto count = [&]() { return (p < Type(5)).count(); };
+  SMARTIT_TEST_ASSERT(count, 2);
+
+  auto first = []() { return pack_type::mask_type::first(3).count(); };
+  SMARTIT_TEST_ASSERT(first, 3);
+
+  auto selected = [&]() { return smit::simd::max(p, q)[0]; };
+  SMARTIT_TEST_ASSERT(selected, 2);
+
+  auto partial = [&]() {
+    Type out[4] = {0, 0, 0, 0};
+    pack_type::load(values, 2).store(out);
+    return out[0] == 1 && out[1] == 4 && out[2] == 0 && out[3] == 0;
+  };
+  SMARTIT_TEST_ASSERT(partial, true);
+
+  auto root = [&]() { return smit::simd::sqrt(p)[2]; };
+  SMARTIT_TEST_ASSERT(root, 3);
+}
+
+template <typename Type> void test_vector_batch() {
+
+  // the size is not a multiple of the number of lanes
+  smit::vector<smit::point_3d<Type>> a(37);
+
+  Type i = 0;
+  for (auto it = a.begin(); it != a.end(); ++it, ++i) {
+    it->x() = i;
+    it->y() = 2 * i;
+    it->z() = 3 * i;
+  }
+
+  a.template for_each_batch<4>([](auto &b) {
+    b.x() *= 2;
+    b.z() = b.x() + b.y();
+  });
+
+  auto check = [&a]() {
+    for (size_t i = 0; i < a.size(); ++i)
+      if (a[i].x() != Type(2 * i) || a[i].y() != Type(2 * i) ||
+          a[i].z() != Type(4 * i))
+        return false;
+    return true;
+  };
+  SMARTIT_TEST_ASSERT(check, true);
+
+  // read-only pass using the number of active lanes
+  auto const &c = a;
+
+  size_t total = 0;
+  Type dot = 0;
+  c.for_each_batch([&](auto const &b, size_t n) {
+    total += n;
+    dot += smit::simd::sum(smit::dot(b, b));
+  });
+
+  auto expected = [&a]() {
+    Type s = 0;
+    for (auto it = a.cbegin(); it != a.cend(); ++it)
+      s += smit::dot(*it, *it);
+    return s;
+  };
+
+  SMARTIT_TEST_ASSERT([&total]() { return total; }, a.size());
+  SMARTIT_TEST_ASSERT([&dot]() { return dot; }, expected());
+}
+
+template <typename Type> void test_array_batch() {
+
+  smit::array<smit::test::two_single_values<Type>, 10> a;
+
+  Type i = 0;
+  for (auto it = a.begin(); it != a.end(); ++it, ++i) {
+    it->first().value() = i;
+    it->second().value() = 0;
+  }
+
+  a.template for_each_batch<4>([](auto &b) {
+    b.second().value() = b.first().value() + Type(1);
+  });
+
+  auto check = [&a]() {
+    for (size_t i = 0; i < a.size(); ++i)
+      if (a[i].second().value() != Type(i + 1))
+        return false;
+    return true;
+  };
+  SMARTIT_TEST_ASSERT(check, true);
+}
+
+/// Whether a pointer is aligned to the given number of bytes
+bool is_aligned(void const *ptr, size_t alignment) {
+  return reinterpret_cast<std::uintptr_t>(ptr) % alignment == 0;
+}
+
+template <typename Type> void test_aligned_columns() {
+
+  // nested columns are aligned too
+  smit::vector<smit::point_with_vector_3d<Type>> v(13);
+
+  auto vector = [&v]() {
+    return is_aligned(v.template data<0, 0>(), 64) &&
+           is_aligned(v.template data<0, 2>(), 64) &&
+           is_aligned(v.template data<1, 1>(), 64) &&
+           v.template data<1, 1>() == &v[0].vector().y();
+  };
+  SMARTIT_TEST_ASSERT(vector, true);
+
+  smit::array<smit::point_3d<Type>, 5, 32> a;
+
+  auto array = [&a]() {
+    auto const &c = a;
+    return is_aligned(c.template data<0>(), 32) &&
+           is_aligned(c.template data<1>(), 32) &&
+           is_aligned(c.template data<2>(), 32) &&
+           c.template data<2>() == &c[0].z();
+  };
+  SMARTIT_TEST_ASSERT(array, true);
+
+  // the default alignment is that of the types
+  SMARTIT_TEST_ASSERT(
+      []() { return sizeof(smit::array<smit::point_3d<Type>, 5>); },
+      3 * 5 * sizeof(Type));
+}
+
+template <typename Type> void test_padded_batch() {
+
+  // the size is not a multiple of the number of lanes
+  smit::vector<smit::point_3d<Type>> a(37);
+
+  Type i = 0;
+  for (auto it = a.begin(); it != a.end(); ++it, ++i) {
+    it->x() = i;
+    it->y() = 2 * i;
+    it->z() = 0;
+  }
+
+  size_t total = 0;
+  a.template for_each_padded_batch<4>([&total](auto &b, size_t n) {
+    b.z() = b.x() + b.y();
+    total += n;
+  });
+
+  auto check = [&a]() {
+    for (size_t i = 0; i < a.size(); ++i)
+      if (a[i].z() != Type(3 * i))
+        return false;
+    return a.size() == 37;
+  };
+  SMARTIT_TEST_ASSERT(check, true);
+  SMARTIT_TEST_ASSERT([&total]() { return total; }, a.size());
+
+  // the values are kept when the vector grows
+  a.resize(40);
+  SMARTIT_TEST_ASSERT([&a]() { return a[36].z(); }, Type(3 * 36));
+  SMARTIT_TEST_ASSERT([&a]() { return a[39].z(); }, Type(0));
+}
+
+int main() {
+
+  smit::test::test_collector pcoll("test-pack");
+  SMARTIT_TEST_SCOPE_FUNCTION(pcoll, &test_pack<int>);
+  SMARTIT_TEST_SCOPE_FUNCTION(pcoll, &test_pack<float>);
+  SMARTIT_TEST_SCOPE_FUNCTION(pcoll, &test_pack<double>);
+
+  smit::test::test_collector bcoll("test-batch");
+  SMARTIT_TEST_SCOPE_FUNCTION(bcoll, &test_vector_batch<int>);
+  SMARTIT_TEST_SCOPE_FUNCTION(bcoll, &test_vector_batch<float>);
+  SMARTIT_TEST_SCOPE_FUNCTION(bcoll, &test_vector_batch<double>);
+  SMARTIT_TEST_SCOPE_FUNCTION(bcoll, &test_array_batch<int>);
+  SMARTIT_TEST_SCOPE_FUNCTION(bcoll, &test_array_batch<float>);
+  SMARTIT_TEST_SCOPE_FUNCTION(bcoll, &test_array_batch<double>);
+  SMARTIT_TEST_SCOPE_FUNCTION(bcoll, &test_aligned_columns<int>);
+  SMARTIT_TEST_SCOPE_FUNCTION(bcoll, &test_aligned_columns<float>);
+  SMARTIT_TEST_SCOPE_FUNCTION(bcoll, &test_aligned_columns<double>);
+  SMARTIT_TEST_SCOPE_FUNCTION(bcoll, &test_padded_batch<int>);
+  SMARTIT_TEST_SCOPE_FUNCTION(bcoll, &test_padded_batch<float>);
+  SMARTIT_TEST_SCOPE_FUNCTION(bcoll, &test_padded_batch<double>);
+
+  return smit::test::combined_status(pcoll.status(), bcoll.status());
+}
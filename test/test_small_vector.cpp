@@ -0,0 +1,207 @@
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+
+#include "smartit/algorithm.hpp"
+#include "smartit/arena.hpp"
+#include "smartit/small_vector.hpp"
+#include "smartit/test.hpp"
+#include "smartit/types.hpp"
+
+/// Whether the address of a value lies inside an object
+template <class T, class Object>
+bool inside(T const *p, Object const &object) {
+  auto const c = reinterpret_cast<unsigned char const *>(p);
+  auto const o = reinterpret_cast<unsigned char const *>(&object);
+  return c >= o && c < o + sizeof(object);
+}
+
+template <typename Type> void test_inline() {
+
+  smit::small_vector<smit::point_with_vector_3d<Type>, 8> v;
+
+  for (size_t i = 0; i < 8; ++i)
+    v.emplace_back(smit::point_3d<Type>(Type(i), Type(2 * i), Type(0)),
+                   smit::point_3d<Type>(Type(0), Type(0), Type(3 * i)));
+
+  // all the columns, including those of the nested objects, are stored
+  // inside the object, aligned to a cache line
+  auto storage = [&]() {
+    return v.is_inline() && v.capacity() == 8 &&
+           inside(&v[0].point().x(), v) && inside(&v[7].vector().z(), v) &&
+           reinterpret_cast<std::uintptr_t>(v.template data<1, 2>()) %
+                   smit::core::cache_line_size ==
+               0;
+  };
+  SMARTIT_TEST_ASSERT(storage, true);
+
+  auto values = [&]() {
+    for (size_t i = 0; i < v.size(); ++i)
+      if (v[i].point().x() != Type(i) || v[i].point().y() != Type(2 * i) ||
+          v[i].vector().z() != Type(3 * i))
+        return false;
+    return v.size() == 8;
+  };
+  SMARTIT_TEST_ASSERT(values, true);
+
+  // the elements are moved to the heap beyond the inline capacity
+  v.push_back(v[7]);
+
+  auto spilled = [&]() {
+    return !v.is_inline() && !inside(&v[0].point().x(), v) &&
+           v.capacity() >= 9 && v[8].point().x() == Type(7) &&
+           v[3].vector().z() == Type(9);
+  };
+  SMARTIT_TEST_ASSERT(spilled, true);
+
+  // the standard algorithms work on the proxy references
+  std::reverse(v.begin(), v.end());
+  SMARTIT_TEST_ASSERT([&v]() { return v[8].point().y(); }, Type(0));
+  SMARTIT_TEST_ASSERT([&v]() { return v[0].vector().z(); }, Type(21));
+}
+
+template <typename Type> void test_copy_move() {
+
+  using vector_type = smit::small_vector<smit::point_3d<Type>, 4>;
+
+  auto fill = [](vector_type &v, size_t n, Type offset) {
+    v.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+      v[i].x() = Type(i) + offset;
+      v[i].y() = Type(0);
+      v[i].z() = Type(0);
+    }
+  };
+
+  auto check = [](vector_type const &v, size_t n, Type offset) {
+    if (v.size() != n)
+      return false;
+    for (size_t i = 0; i < n; ++i)
+      if (v[i].x() != Type(i) + offset)
+        return false;
+    return true;
+  };
+
+  for (size_t n : {size_t(3), size_t(10)})
+    for (size_t m : {size_t(2), size_t(20)}) {
+
+      vector_type a, b;
+      fill(a, n, Type(0));
+      fill(b, m, Type(100));
+
+      // copies do not share the memory
+      vector_type c = a;
+      c[0].x() = Type(50);
+      SMARTIT_TEST_ASSERT([&]() { return check(a, n, Type(0)); }, true);
+      bool const small = n <= 4;
+      SMARTIT_TEST_ASSERT([&]() { return c.is_inline(); }, small);
+
+      // swaps work with any combination of inline and heap storage
+      a.swap(b);
+      auto swapped = [&]() {
+        return check(a, m, Type(100)) && check(b, n, Type(0)) &&
+               a.is_inline() == (m <= 4) && b.is_inline() == (n <= 4);
+      };
+      SMARTIT_TEST_ASSERT(swapped, true);
+
+      // moved vectors are left empty, and can be reused
+      vector_type d = std::move(a);
+      auto moved = [&]() {
+        return check(d, m, Type(100)) && a.empty() && a.is_inline() &&
+               (m <= 4 || !inside(&d[0].x(), d));
+      };
+      SMARTIT_TEST_ASSERT(moved, true);
+
+      fill(a, n + m, Type(1));
+      b = a;
+      SMARTIT_TEST_ASSERT([&]() { return check(b, n + m, Type(1)); }, true);
+    }
+}
+
+template <typename Type> void test_push_back_aliased() {
+
+  // the appended element refers to the vector itself, while it grows from
+  // the inline buffer to the heap and then between heap blocks
+  smit::small_vector<smit::point_3d<Type>, 2> v;
+  v.emplace_back(1, 2, 3);
+  for (size_t i = 0; i < 40; ++i)
+    v.push_back(v[0]);
+
+  for (size_t i = 0; i < 40; ++i)
+    v.emplace_back(v[i].x(), v[i].y(), v[i].z());
+
+  auto check = [&v]() {
+    for (size_t i = 0; i < v.size(); ++i)
+      if (v[i].x() != Type(1) || v[i].y() != Type(2) || v[i].z() != Type(3))
+        return false;
+    return v.size() == 81 && !v.is_inline();
+  };
+  SMARTIT_TEST_ASSERT(check, true);
+}
+
+template <typename Type> void test_algorithms() {
+
+  smit::small_vector<smit::point_3d<Type>, 16> v(12);
+  for (size_t i = 0; i < v.size(); ++i) {
+    v[i].x() = Type(11 - i);
+    v[i].y() = Type(i);
+    v[i].z() = Type(1);
+  }
+
+  smit::sort(v, [](auto const &p) { return p.x(); });
+  smit::inclusive_scan<2>(v);
+
+  auto sorted = [&]() {
+    for (size_t i = 0; i < v.size(); ++i)
+      if (v[i].x() != Type(i) || v[i].y() != Type(11 - i) ||
+          v[i].z() != Type(i + 1))
+        return false;
+    return true;
+  };
+  SMARTIT_TEST_ASSERT(sorted, true);
+
+  SMARTIT_TEST_ASSERT([&v]() { return smit::sum<1>(v); }, Type(66));
+
+  // batches of elements
+  size_t count = 0;
+  v.for_each_batch([&count](auto &b, size_t n) {
+    b.y() = b.x() + b.y();
+    count += n;
+  });
+  SMARTIT_TEST_ASSERT([&count]() { return count; }, size_t(12));
+  SMARTIT_TEST_ASSERT([&v]() { return v[5].y(); }, Type(11));
+}
+
+void test_arena() {
+
+  smit::arena a(1u << 12);
+
+  smit::small_vector<smit::point_3d<float>, 4, smit::arena_allocator> v{a};
+
+  v.resize(4);
+  SMARTIT_TEST_ASSERT([&a]() { return a.number_of_blocks(); }, size_t(0));
+
+  v.resize(5);
+  SMARTIT_TEST_ASSERT([&a]() { return a.number_of_blocks(); }, size_t(1));
+  SMARTIT_TEST_ASSERT([&v]() { return v.is_inline(); }, false);
+}
+
+int main() {
+
+  smit::test::test_collector coll("test-small-vector");
+  SMARTIT_TEST_SCOPE_FUNCTION(coll, &test_inline<int>);
+  SMARTIT_TEST_SCOPE_FUNCTION(coll, &test_inline<float>);
+  SMARTIT_TEST_SCOPE_FUNCTION(coll, &test_inline<double>);
+  SMARTIT_TEST_SCOPE_FUNCTION(coll, &test_copy_move<int>);
+  SMARTIT_TEST_SCOPE_FUNCTION(coll, &test_copy_move<float>);
+  SMARTIT_TEST_SCOPE_FUNCTION(coll, &test_copy_move<double>);
+  SMARTIT_TEST_SCOPE_FUNCTION(coll, &test_push_back_aliased<int>);
+  SMARTIT_TEST_SCOPE_FUNCTION(coll, &test_push_back_aliased<float>);
+  SMARTIT_TEST_SCOPE_FUNCTION(coll, &test_push_back_aliased<double>);
+  SMARTIT_TEST_SCOPE_FUNCTION(coll, &test_algorithms<int>);
+  SMARTIT_TEST_SCOPE_FUNCTION(coll, &test_algorithms<float>);
+  SMARTIT_TEST_SCOPE_FUNCTION(coll, &test_algorithms<double>);
+  SMARTIT_TEST_SCOPE_FUNCTION(coll, &test_arena);
+
+  return coll.status();
+}
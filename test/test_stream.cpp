@@ -0,0 +1,195 @@
+#include <sstream>
+#include <stdexcept>
+
+#include "smartit/array.hpp"
+#include "smartit/stream.hpp"
+#include "smartit/test.hpp"
+#include "smartit/tiled_vector.hpp"
+#include "smartit/types.hpp"
+#include "smartit/vector.hpp"
+
+template <typename Type> void test_stream() {
+
+  size_t const size = 50;
+
+  smit::vector<smit::point_with_vector_3d<Type>> v(size);
+  for (size_t i = 0; i < size; ++i) {
+    v[i].point().x() = Type(i);
+    v[i].point().y() = Type(2 * i);
+    v[i].vector().z() = Type(3 * i);
+  }
+
+  std::stringstream stream;
+
+  {
+    smit::stream_writer<smit::point_with_vector_3d<Type>> writer(stream, 16);
+    writer.write(v);
+    writer.close();
+  }
+
+  // read the chunks one by one
+  smit::stream_reader<smit::point_with_vector_3d<Type>> reader(stream);
+
+  smit::vector<smit::point_with_vector_3d<Type>> r;
+  r.reserve(size);
+
+  size_t chunks = 0;
+  while (reader.next()) {
+    reader.append(r);
+    ++chunks;
+  }
+
+  auto check = [&]() {
+    for (size_t i = 0; i < size; ++i)
+      if (r[i].point().x() != Type(i) || r[i].point().y() != Type(2 * i) ||
+          r[i].vector().z() != Type(3 * i) || r[i].vector().x() != 0)
+        return false;
+    return r.size() == size && chunks == 4;
+  };
+  SMARTIT_TEST_ASSERT(check, true);
+
+  SMARTIT_TEST_ASSERT(reader.next, false);
+}
+
+template <typename Type> void test_partial() {
+
+  smit::array<smit::point_3d<Type>, 20> a;
+  for (size_t i = 0; i < a.size(); ++i) {
+    a[i].x() = Type(i);
+    a[i].y() = Type(i + 1);
+    a[i].z() = Type(i + 2);
+  }
+
+  std::stringstream stream;
+
+  {
+    smit::stream_writer<smit::point_3d<Type>> writer(stream);
+    writer.write_chunk(a, 0, 10);
+    writer.write_chunk(a, 10, 10);
+  }
+
+  smit::stream_reader<smit::point_3d<Type>> reader(stream);
+
+  smit::array<smit::point_3d<Type>, 10> b;
+  for (auto p : b) {
+    p.x() = 0;
+    p.y() = 0;
+    p.z() = 0;
+  }
+
+  // skip the first chunk and read two fields of the second
+  reader.next();
+  reader.next();
+  reader.template read<0, 2>(b, 0);
+
+  auto check = [&]() {
+    for (size_t i = 0; i < b.size(); ++i)
+      if (b[i].x() != Type(i + 10) || b[i].y() != 0 ||
+          b[i].z() != Type(i + 12))
+        return false;
+    return reader.rows() == 10 && !reader.next();
+  };
+  SMARTIT_TEST_ASSERT(check, true);
+}
+
+template <typename Type> void test_tiled() {
+
+  size_t const size = 10;
+
+  smit::tiled_vector<smit::point_3d<Type>, 4> t(size);
+  for (size_t i = 0; i < size; ++i) {
+    t[i].x() = Type(i);
+    t[i].y() = Type(i + 100);
+    t[i].z() = Type(i + 200);
+  }
+
+  std::stringstream stream;
+
+  {
+    // chunks starting and ending in the middle of the tiles
+    smit::stream_writer<smit::point_3d<Type>> writer(stream, 3);
+    writer.write(t);
+  }
+
+  smit::stream_reader<smit::point_3d<Type>> reader(stream);
+
+  smit::vector<smit::point_3d<Type>> v;
+  while (reader.next())
+    reader.append(v);
+
+  std::stringstream copy;
+
+  {
+    smit::stream_writer<smit::point_3d<Type>> writer(copy, 7);
+    writer.write(v);
+  }
+
+  smit::stream_reader<smit::point_3d<Type>> copy_reader(copy);
+
+  smit::tiled_vector<smit::point_3d<Type>, 4> r;
+  while (copy_reader.next())
+    copy_reader.append(r);
+
+  auto check = [&]() {
+    if (v.size() != size || r.size() != size)
+      return false;
+    for (size_t i = 0; i < size; ++i)
+      if (v[i].x() != Type(i) || v[i].y() != Type(i + 100) ||
+          v[i].z() != Type(i + 200) || r[i].x() != Type(i) ||
+          r[i].y() != Type(i + 100) || r[i].z() != Type(i + 200))
+        return false;
+    return true;
+  };
+  SMARTIT_TEST_ASSERT(check, true);
+}
+
+void test_errors() {
+
+  std::stringstream stream;
+  {
+    smit::stream_writer<smit::point_3d<float>> writer(stream);
+    writer.write(smit::vector<smit::point_3d<float>>(5));
+  }
+
+  // the fields must match those in the stream
+  auto wrong_type = [&]() {
+    try {
+      smit::stream_reader<smit::point_3d<double>> reader(stream);
+    } catch (std::runtime_error const &) {
+      return true;
+    }
+    return false;
+  };
+  SMARTIT_TEST_ASSERT(wrong_type, true);
+
+  // truncated streams
+  auto truncated = [&]() {
+    std::stringstream s(stream.str().substr(0, stream.str().size() - 20));
+    try {
+      smit::stream_reader<smit::point_3d<float>> reader(s);
+      while (reader.next())
+        reader.skip();
+    } catch (std::runtime_error const &) {
+      return true;
+    }
+    return false;
+  };
+  SMARTIT_TEST_ASSERT(truncated, true);
+}
+
+int main() {
+
+  smit::test::test_collector coll("test-stream");
+  SMARTIT_TEST_SCOPE_FUNCTION(coll, &test_stream<int>);
+  SMARTIT_TEST_SCOPE_FUNCTION(coll, &test_stream<float>);
+  SMARTIT_TEST_SCOPE_FUNCTION(coll, &test_stream<double>);
+  SMARTIT_TEST_SCOPE_FUNCTION(coll, &test_partial<int>);
+  SMARTIT_TEST_SCOPE_FUNCTION(coll, &test_partial<float>);
+  SMARTIT_TEST_SCOPE_FUNCTION(coll, &test_partial<double>);
+  SMARTIT_TEST_SCOPE_FUNCTION(coll, &test_tiled<int>);
+  SMARTIT_TEST_SCOPE_FUNCTION(coll, &test_tiled<float>);
+  SMARTIT_TEST_SCOPE_FUNCTION(coll, &test_tiled<double>);
+  SMARTIT_TEST_SCOPE_FUNCTION(coll, &test_errors);
+
+  return coll.status();
+}
@@ -0,0 +1,154 @@
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "smartit/algorithm.hpp"
+#include "smartit/test.hpp"
+#include "smartit/thread_pool.hpp"
+#include "smartit/types.hpp"
+#include "smartit/vector.hpp"
+
+void test_parallel_for() {
+
+  smit::thread_pool pool(3);
+
+  SMARTIT_TEST_ASSERT(pool.size, 3);
+
+  size_t const size = 10000;
+
+  std::vector<std::atomic<int>> counts(size);
+
+  // uneven work per element
+  pool.parallel_for(size, 100, [&counts](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      volatile size_t w = 0;
+      for (size_t j = 0; j < i % 1000; ++j)
+        w = w + j;
+      ++counts[i];
+    }
+  });
+
+  auto check = [&counts]() {
+    for (auto const &c : counts)
+      if (c != 1)
+        return false;
+    return true;
+  };
+  SMARTIT_TEST_ASSERT(check, true);
+}
+
+void test_nested() {
+
+  smit::thread_pool pool(3);
+
+  // outer loop over containers and inner loop over the elements
+  std::vector<smit::vector<smit::point_3d<float>>> containers;
+  for (size_t i = 0; i < 8; ++i)
+    containers.emplace_back(1000 * (i + 1));
+
+  pool.parallel_for(containers.size(), 1, [&](size_t begin, size_t end) {
+    for (size_t c = begin; c < end; ++c) {
+      auto &v = containers[c];
+      pool.parallel_for(v.size(), 256, [&v, c](size_t b, size_t e) {
+        for (auto it = v.begin() + b; it != v.begin() + e; ++it)
+          it->x() = float(c);
+      });
+    }
+  });
+
+  auto check = [&containers]() {
+    for (size_t c = 0; c < containers.size(); ++c)
+      for (auto it = containers[c].cbegin(); it != containers[c].cend(); ++it)
+        if (it->x() != float(c))
+          return false;
+    return true;
+  };
+  SMARTIT_TEST_ASSERT(check, true);
+}
+
+void test_tasks() {
+
+  smit::thread_pool pool(3);
+
+  size_t const n = 4;
+
+  std::mutex mutex;
+  std::set<std::thread::id> threads;
+  std::atomic<size_t> started{0};
+
+  // each task waits for the rest to start, so a few tasks are run by
+  // different threads even if they are less than the chunk granularity
+  pool.parallel_tasks(n, [&](size_t) {
+    {
+      std::lock_guard<std::mutex> lock{mutex};
+      threads.insert(std::this_thread::get_id());
+    }
+    ++started;
+    auto const timeout =
+        std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (started != n && std::chrono::steady_clock::now() < timeout)
+      std::this_thread::yield();
+  });
+
+  SMARTIT_TEST_ASSERT([&threads]() { return threads.size(); }, n);
+}
+
+void test_reduce() {
+
+  size_t const size = 100000;
+
+  std::vector<double> values(size);
+  for (size_t i = 0; i < size; ++i)
+    values[i] = 1. / (i + 1);
+
+  auto sum = [&values](smit::thread_pool &pool) {
+    return pool.parallel_reduce(
+        values.size(), 1000, 0.,
+        [&values](size_t begin, size_t end) {
+          double s = 0;
+          for (size_t i = begin; i < end; ++i)
+            s += values[i];
+          return s;
+        },
+        [](double a, double b) { return a + b; });
+  };
+
+  smit::thread_pool serial(0), parallel(3);
+
+  // the result does not depend on the number of threads
+  auto deterministic = [&]() { return sum(serial) == sum(parallel); };
+  SMARTIT_TEST_ASSERT(deterministic, true);
+}
+
+void test_exception() {
+
+  smit::thread_pool pool(2);
+
+  auto propagated = [&pool]() {
+    try {
+      pool.parallel_for(1000, 64, [](size_t begin, size_t) {
+        if (begin != 0)
+          throw begin;
+      });
+    } catch (size_t) {
+      return true;
+    }
+    return false;
+  };
+  SMARTIT_TEST_ASSERT(propagated, true);
+}
+
+int main() {
+
+  smit::test::test_collector coll("test-thread-pool");
+  SMARTIT_TEST_SCOPE_FUNCTION(coll, &test_parallel_for);
+  SMARTIT_TEST_SCOPE_FUNCTION(coll, &test_nested);
+  SMARTIT_TEST_SCOPE_FUNCTION(coll, &test_tasks);
+  SMARTIT_TEST_SCOPE_FUNCTION(coll, &test_reduce);
+  SMARTIT_TEST_SCOPE_FUNCTION(coll, &test_exception);
+
+  return coll.status();
+}
@@ -0,0 +1,213 @@
+#include "smartit/algorithm.hpp"
+#include "smartit/kernels.hpp"
+#include "smartit/test.hpp"
+#include "smartit/tiled_vector.hpp"
+#include "smartit/types.hpp"
+
+template <typename Type> void test_access() {
+
+  // the size is not a multiple of the number of elements in a tile
+  size_t const size = 21;
+
+  smit::tiled_vector<smit::point_3d<Type>, 4> v(size);
+
+  auto zero = [&]() {
+    for (auto p : v)
+      if (p.x() != 0 || p.y() != 0 || p.z() != 0)
+        return false;
+    return v.size() == size && v.capacity() >= size;
+  };
+  SMARTIT_TEST_ASSERT(zero, true);
+
+  for (size_t i = 0; i < size; ++i) {
+    v[i].x() = Type(i);
+    v[i].y() = Type(2 * i);
+    v[i].z() = Type(3 * i);
+  }
+
+  // values of each field are contiguous within a tile
+  auto layout = [&]() {
+    for (size_t i = 0; i < size; ++i)
+      if (&v[i].x() - &v[i - i % 4].x() != std::ptrdiff_t(i % 4))
+        return false;
+    return true;
+  };
+  SMARTIT_TEST_ASSERT(layout, true);
+
+  auto values = [&]() {
+    for (size_t i = 0; i < size; ++i)
+      if (v[i].x() != Type(i) || v[i].y() != Type(2 * i) ||
+          v[i].z() != Type(3 * i))
+        return false;
+    return true;
+  };
+  SMARTIT_TEST_ASSERT(values, true);
+
+  // copies do not share the memory
+  auto c = v;
+  c[0].x() = 100;
+
+  auto copy = [&]() {
+    for (size_t i = 1; i < size; ++i)
+      if (c[i].x() != v[i].x() || c[i].y() != v[i].y() ||
+          c[i].z() != v[i].z())
+        return false;
+    return c.size() == size && c[0].x() == 100 && v[0].x() == 0;
+  };
+  SMARTIT_TEST_ASSERT(copy, true);
+
+  // elements are preserved on reallocation
+  smit::tiled_vector<smit::point_3d<Type>, 4> g;
+  for (size_t i = 0; i < size; ++i)
+    g.push_back(v[i]);
+  g.emplace_back(Type(1), Type(2), Type(3));
+
+  auto append = [&]() {
+    for (size_t i = 0; i < size; ++i)
+      if (g[i].x() != Type(i) || g[i].y() != Type(2 * i) ||
+          g[i].z() != Type(3 * i))
+        return false;
+    return g.size() == size + 1 && g[size].x() == 1 && g[size].y() == 2 &&
+           g[size].z() == 3;
+  };
+  SMARTIT_TEST_ASSERT(append, true);
+}
+
+template <typename Type> void test_nested() {
+
+  size_t const size = 13;
+
+  smit::tiled_vector<smit::point_with_vector_3d<Type>> v;
+
+  for (size_t i = 0; i < size; ++i) {
+    smit::point_with_vector_3d<Type> p;
+    p.point().x() = Type(i);
+    p.point().y() = 0;
+    p.point().z() = 0;
+    p.vector().x() = 0;
+    p.vector().y() = 0;
+    p.vector().z() = Type(2 * i);
+    v.push_back(p);
+  }
+
+  auto nested = [&]() {
+    for (size_t i = 0; i < size; ++i) {
+      auto e = v[i];
+      if (e.point().x() != Type(i) || e.point().y() != 0 ||
+          e.vector().y() != 0 || e.vector().z() != Type(2 * i))
+        return false;
+    }
+    return true;
+  };
+  SMARTIT_TEST_ASSERT(nested, true);
+
+  // all the fields of an element are in the same tile
+  auto tile = [&]() {
+    using layout = typename decltype(v)::tile_layout;
+    for (size_t i = 0; i < size; ++i) {
+      auto const first = reinterpret_cast<char const *>(&v[i].point().x());
+      auto const last = reinterpret_cast<char const *>(&v[i].vector().z());
+      if (last - first >= std::ptrdiff_t(layout::bytes))
+        return false;
+    }
+    return true;
+  };
+  SMARTIT_TEST_ASSERT(tile, true);
+}
+
+template <typename Type> void test_push_back_aliased() {
+
+  // the appended element refers to the vector itself, across several
+  // reallocations of the tiles
+  smit::tiled_vector<smit::point_3d<Type>, 4> v;
+  v.emplace_back(1, 2, 3);
+  for (size_t i = 0; i < 40; ++i)
+    v.push_back(v[0]);
+
+  auto check = [&v]() {
+    for (size_t i = 0; i < v.size(); ++i)
+      if (v[i].x() != Type(1) || v[i].y() != Type(2) || v[i].z() != Type(3))
+        return false;
+    return v.size() == 41;
+  };
+  SMARTIT_TEST_ASSERT(check, true);
+}
+
+template <typename Type> void test_batches() {
+
+  size_t const size = 37;
+
+  smit::tiled_vector<smit::point_3d<Type>, 16> a(size), b(size), out;
+
+  for (size_t i = 0; i < size; ++i) {
+    a[i].x() = Type(i);
+    a[i].y() = Type(2 * i);
+    a[i].z() = Type(3 * i);
+    b[i].x() = 1;
+    b[i].y() = 2;
+    b[i].z() = 3;
+  }
+
+  Type const s = 2;
+
+  out = a + s * b;
+
+  auto expression = [&]() {
+    for (size_t i = 0; i < size; ++i)
+      if (out[i].x() != Type(i + 2) || out[i].y() != Type(2 * i + 4) ||
+          out[i].z() != Type(3 * i + 6))
+        return false;
+    return out.size() == size;
+  };
+  SMARTIT_TEST_ASSERT(expression, true);
+
+  out.for_each_batch([](auto &batch) { batch.x() -= batch.x(); });
+
+  auto batches = [&]() {
+    for (size_t i = 0; i < size; ++i)
+      if (out[i].x() != 0 || out[i].y() != Type(2 * i + 4))
+        return false;
+    return true;
+  };
+  SMARTIT_TEST_ASSERT(batches, true);
+
+  std::vector<Type> d(size);
+  smit::kernels::dot(a, b, d.data());
+
+  auto kernel = [&]() {
+    for (size_t i = 0; i < size; ++i)
+      if (d[i] != Type(14 * i))
+        return false;
+    return true;
+  };
+  SMARTIT_TEST_ASSERT(kernel, true);
+
+  smit::for_each(smit::execution::par, a.begin(), a.end(),
+                 [](auto p) { p.z() = p.x(); });
+
+  auto algorithm = [&]() {
+    for (size_t i = 0; i < size; ++i)
+      if (a[i].z() != Type(i))
+        return false;
+    return true;
+  };
+  SMARTIT_TEST_ASSERT(algorithm, true);
+}
+
+int main() {
+
+  smit::test::test_collector coll("test-tiled-vector");
+  SMARTIT_TEST_SCOPE_FUNCTION(coll, &test_access<int>);
+  SMARTIT_TEST_SCOPE_FUNCTION(coll, &test_access<float>);
+  SMARTIT_TEST_SCOPE_FUNCTION(coll, &test_access<double>);
+  SMARTIT_TEST_SCOPE_FUNCTION(coll, &test_nested<float>);
+  SMARTIT_TEST_SCOPE_FUNCTION(coll, &test_nested<double>);
+  SMARTIT_TEST_SCOPE_FUNCTION(coll, &test_push_back_aliased<int>);
+  SMARTIT_TEST_SCOPE_FUNCTION(coll, &test_push_back_aliased<float>);
+  SMARTIT_TEST_SCOPE_FUNCTION(coll, &test_push_back_aliased<double>);
+  SMARTIT_TEST_SCOPE_FUNCTION(coll, &test_batches<int>);
+  SMARTIT_TEST_SCOPE_FUNCTION(coll, &test_batches<float>);
+  SMARTIT_TEST_SCOPE_FUNCTION(coll, &test_batches<double>);
+
+  return coll.status();
+}
@@ -10,11 +10,11 @@ if __name__ == '__main__':
 
     for dt, ax in (('array', ax0), ('vector', ax1)):
 
-        entries, std, var_std, smit, var_smit = np.loadtxt(
+        entries, std, var_std, smit, var_smit, soa, var_soa = np.loadtxt(
             f'{dt}.txt', dtype=np.float32, delimiter=' ').T
 
         print(f'Values for {dt}')
-        for r in zip(entries, std, var_std, smit, var_smit):
+        for r in zip(entries, std, var_std, smit, var_smit, soa, var_soa):
             print(*r)
 
         ax.set_title(dt)
@@ -22,6 +22,8 @@ if __name__ == '__main__':
                     color='C1', marker='*', ls='-', ms=10, lw=1.5, label='smartit')
         ax.errorbar(entries, 1e3 * std, yerr=np.sqrt(var_smit),
                     color='C0', marker='^', ls='--', ms=10, lw=1.5, label='std')
+        ax.errorbar(entries, 1e3 * soa, yerr=np.sqrt(var_soa),
+                    color='C2', marker='o', ls=':', ms=10, lw=1.5, label='std (SOA)')
         ax.set_xlabel('entries')
         ax.set_xscale('log', nonposx='clip')
         ax.set_ylabel('time (ms)', ha='right', y=1.)
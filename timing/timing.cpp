@@ -10,6 +10,7 @@ template <size_t N, size_t R> void _run_array(std::ofstream &file) {
   std::cout << "- " << N << std::endl;
 
   float total_std = 0, total_smit = 0, total_std_2 = 0, total_smit_2 = 0;
+  float total_soa = 0, total_soa_2 = 0;
 
   // STD
   {
@@ -35,6 +36,28 @@ template <size_t N, size_t R> void _run_array(std::ofstream &file) {
     }
   }
 
+  // STD (hand-written struct of arrays)
+  {
+    std::array<float, N> x, y, z;
+    for (size_t i = 0; i < R; ++i) {
+
+      const auto start = std::clock();
+
+      for (size_t j = 0; j < N; ++j) {
+        x[j] = 1.f;
+        y[j] = 1.f;
+        z[j] = 1.f;
+      }
+
+      const auto end = std::clock();
+
+      const auto t = (end - start) * 1.f / CLOCKS_PER_SEC;
+
+      total_soa += t;
+      total_soa_2 += t * t;
+    }
+  }
+
   // SMIT
   {
     smit::array<smit::point_3d<float>, N> a;
@@ -68,8 +91,13 @@ template <size_t N, size_t R> void _run_array(std::ofstream &file) {
                     2.f * mean_smit * total_smit) *
                    1.f / (R * (R - 1));
 
+  float mean_soa = total_soa * 1.f / R;
+  float var_soa =
+      (total_soa_2 + R * mean_soa * mean_soa - 2.f * mean_soa * total_soa) *
+      1.f / (R * (R - 1));
+
   file << N << " " << mean_std << " " << var_std << " " << mean_smit << " "
-       << var_smit << std::endl;
+       << var_smit << " " << mean_soa << " " << var_soa << std::endl;
 }
 
 void run_array(std::string path) {
@@ -91,6 +119,7 @@ template <size_t N, size_t R> void _run_vector(std::ofstream &file) {
   std::cout << "- " << N << std::endl;
 
   float total_std = 0, total_smit = 0, total_std_2 = 0, total_smit_2 = 0;
+  float total_soa = 0, total_soa_2 = 0;
 
   // STD
   {
@@ -116,6 +145,28 @@ template <size_t N, size_t R> void _run_vector(std::ofstream &file) {
     }
   }
 
+  // STD (hand-written struct of arrays)
+  {
+    std::vector<float> x(N), y(N), z(N);
+    for (size_t i = 0; i < R; ++i) {
+
+      const auto start = std::clock();
+
+      for (size_t j = 0; j < N; ++j) {
+        x[j] = 1.f;
+        y[j] = 1.f;
+        z[j] = 1.f;
+      }
+
+      const auto end = std::clock();
+
+      const auto t = (end - start) * 1.f / CLOCKS_PER_SEC;
+
+      total_soa += t;
+      total_soa_2 += t * t;
+    }
+  }
+
   // SMIT
   {
     smit::vector<smit::point_3d<float>> a(N);
@@ -149,8 +200,13 @@ template <size_t N, size_t R> void _run_vector(std::ofstream &file) {
                     2.f * mean_smit * total_smit) *
                    1.f / (R * (R - 1));
 
+  float mean_soa = total_soa * 1.f / R;
+  float var_soa =
+      (total_soa_2 + R * mean_soa * mean_soa - 2.f * mean_soa * total_soa) *
+      1.f / (R * (R - 1));
+
   file << N << " " << mean_std << " " << var_std << " " << mean_smit << " "
-       << var_smit << std::endl;
+       << var_smit << " " << mean_soa << " " << var_soa << std::endl;
 }
 
 void run_vector(std::string path) {